@@ -0,0 +1,74 @@
+// Text export (getMetrics, what the notebooks had to regex-parse) against the
+// columnar tables of exportCluster : time to write and size on disk.
+#include "ClusterExport.hpp"
+#include "KubernetesCluster.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+static const int SERVERS = 64;
+static const int PODS = 100000;
+static const int RUNS = 5;
+static const char* IMAGES[] = {"nginx:latest", "redis:alpine", "mysql:8", "fluentd:latest", "node:16"};
+
+static uint64_t fileSize(const string& filename) {
+    ifstream in(filename, ios::binary | ios::ate);
+    return static_cast<uint64_t>(in.tellg());
+}
+
+template <typename F>
+static double bestSeconds(F run) {
+    vector<double> samples;
+    for (int i = 0; i < RUNS; ++i) {
+        auto start = chrono::steady_clock::now();
+        run();
+        samples.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return *min_element(samples.begin(), samples.end());
+}
+
+int main() {
+    KubernetesCluster cluster("bench");
+    for (int n = 0; n < SERVERS; ++n) {
+        cluster.addServer(make_shared<Server>("n" + to_string(n), 2048.0, 4096.0));
+    }
+    for (int i = 0; i < PODS; ++i) {
+        auto pod = make_unique<Pod>("pod-" + to_string(i));
+        pod->addContainer(make_unique<Container>("app", 0.5, 1.0, IMAGES[i % 5]));
+        pod->addContainer(make_unique<Container>("sidecar", 0.1, 0.2, IMAGES[(i + 3) % 5]));
+        cluster.schedulePod(pod);
+    }
+
+    const string text = "bench_export.txt";
+    const string prefix = "bench_export_";
+
+    const double textSeconds = bestSeconds([&]() {
+        ofstream file(text);
+        file << cluster.getMetrics();
+    });
+    uint64_t columnarBytes = 0;
+    const double columnarSeconds = bestSeconds([&]() {
+        columnarBytes = exportCluster(cluster, prefix);
+    });
+    const uint64_t textBytes = fileSize(text);
+
+    const size_t rows = SERVERS + PODS + 2 * PODS;
+    cout << fixed << setprecision(1);
+    cout << "rows: " << rows << " (" << SERVERS << " servers, " << PODS << " pods, " << 2 * PODS << " containers)\n";
+    cout << "text      : " << textBytes / 1024 << " KiB in " << textSeconds * 1000 << " ms ("
+         << textBytes / textSeconds / 1e6 << " MB/s)\n";
+    cout << "columnar  : " << columnarBytes / 1024 << " KiB in " << columnarSeconds * 1000 << " ms ("
+         << columnarBytes / columnarSeconds / 1e6 << " MB/s, "
+         << rows / columnarSeconds / 1e6 << " M rows/s)\n";
+    cout << setprecision(2) << "speedup " << textSeconds / columnarSeconds
+         << "x, size ratio " << static_cast<double>(columnarBytes) / textBytes << "\n";
+
+    remove(text.c_str());
+    for (const char* table: {"servers", "pods", "containers"}) {
+        remove((prefix + table + ".col").c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Weak scaling of ClusterFederation::deployPods : every shard gets the same
+// number of servers and pods, so with perfect parallelism the time stays flat
+// and the throughput grows linearly with the number of shards.
+#include "ClusterFederation.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+static const int SERVERS_PER_SHARD = 64;
+static const int PODS_PER_SHARD = 40000;
+
+static double runOnce(size_t shardCount) {
+    ClusterFederation fed(ShardRouting::Hash);
+    for (size_t s = 0; s < shardCount; ++s) {
+        size_t shard = fed.addShard("zone" + to_string(s));
+        for (int n = 0; n < SERVERS_PER_SHARD; ++n) {
+            fed.addServer(shard, make_shared<Server>("z" + to_string(s) + "-n" + to_string(n), 64.0, 128.0));
+        }
+    }
+
+    vector<unique_ptr<Pod>> pods;
+    pods.reserve(shardCount * PODS_PER_SHARD);
+    for (size_t i = 0; i < shardCount * PODS_PER_SHARD; ++i) {
+        auto pod = make_unique<Pod>("pod-" + to_string(i));
+        pod->addContainer(make_unique<Container>("c", 0.05, 0.1, "img"));
+        pods.push_back(move(pod));
+    }
+    // Random arrival order : every shard count then pays the same cache misses on the pods
+    shuffle(pods.begin(), pods.end(), mt19937(42));
+
+    auto start = chrono::steady_clock::now();
+    size_t scheduled = fed.deployPods(pods);
+    auto end = chrono::steady_clock::now();
+
+    if (scheduled != pods.size()) {
+        cerr << "unexpected : " << pods.size() - scheduled << " pods not scheduled" << endl;
+    }
+    return chrono::duration<double>(end - start).count();
+}
+
+int main() {
+    cout << "hardware threads: " << thread::hardware_concurrency() << "\n";
+    cout << "servers/shard: " << SERVERS_PER_SHARD << ", pods/shard: " << PODS_PER_SHARD << "\n\n";
+    cout << setw(8) << "shards" << setw(12) << "time (s)" << setw(14) << "pods/s" << setw(10) << "speedup" << "\n";
+
+    double baseline = 0.0;
+    for (size_t shards = 1; shards <= 16; shards *= 2) {
+        double best = 1e9;
+        for (int run = 0; run < 3; ++run) {
+            best = min(best, runOnce(shards));
+        }
+        double throughput = static_cast<double>(shards * PODS_PER_SHARD) / best;
+        if (shards == 1) {
+            baseline = throughput;
+        }
+        cout << setw(8) << shards << setw(12) << fixed << setprecision(4) << best
+             << setw(14) << setprecision(0) << throughput
+             << setw(10) << setprecision(2) << throughput / baseline << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Pod storage of the cluster : the previous plain vector<unique_ptr<Pod>> (linear search
+// by name) against PodRegistry. Memory is the live heap measured through operator new,
+// iteration sums the cpu of every pod, lookup / removal use random pod names.
+#include "PodRegistry.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <new>
+#include <random>
+
+static size_t liveBytes = 0;
+
+void* operator new(size_t size) {
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    liveBytes += malloc_usable_size(p);
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (p != nullptr) {
+        liveBytes -= malloc_usable_size(p);
+        free(p);
+    }
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+static const int PODS = 100000;
+static const int LOOKUPS = 2000;
+static const int ITERATIONS = 20;
+
+template <typename F>
+static double seconds(F run) {
+    auto start = chrono::steady_clock::now();
+    run();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Both containers get the very same pods, built beforehand
+static vector<unique_ptr<Pod>> makePods(const vector<int>& shapes) {
+    vector<unique_ptr<Pod>> pods;
+    pods.reserve(shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        auto pod = make_unique<Pod>("pod-" + to_string(i));
+        for (int c = 0; c < shapes[i]; ++c) {
+            pod->addContainer(make_unique<Container>("c" + to_string(c), 0.25, 0.5, "img"));
+        }
+        pods.push_back(move(pod));
+    }
+    return pods;
+}
+
+int main() {
+    mt19937 rng(7);
+    uniform_int_distribution<int> containerCount(1, 3);
+    vector<int> shapes(PODS);
+    for (auto& s: shapes) {
+        s = containerCount(rng);
+    }
+    vector<string> names;
+    for (int i = 0; i < LOOKUPS; ++i) {
+        names.push_back("pod-" + to_string(uniform_int_distribution<int>(0, PODS - 1)(rng)));
+    }
+    sort(names.begin(), names.end());
+    names.erase(unique(names.begin(), names.end()), names.end());
+    shuffle(names.begin(), names.end(), rng);
+
+    // --- build : the pods themselves are the same on both sides, only the storage differs
+    size_t before = liveBytes;
+    auto podsForVector = makePods(shapes);
+    const size_t podBytes = liveBytes - before;
+    auto podsForRegistry = makePods(shapes);
+
+    before = liveBytes;
+    vector<unique_ptr<Pod>> plain;
+    const double plainInsert = seconds([&]() {
+        for (auto& pod: podsForVector) {
+            plain.push_back(move(pod));
+        }
+    });
+    const size_t plainBytes = liveBytes - before;
+
+    before = liveBytes;
+    PodRegistry registry;
+    const double registryInsert = seconds([&]() {
+        for (auto& pod: podsForRegistry) {
+            registry.insert(pod);
+        }
+    });
+    const size_t registryBytes = liveBytes - before;
+
+    // --- iteration
+    double sink = 0.0;
+    const double plainIter = seconds([&]() {
+        for (int r = 0; r < ITERATIONS; ++r) {
+            for (const auto& pod: plain) {
+                sink += pod->getCpuRequest();
+            }
+        }
+    });
+    const double registryIter = seconds([&]() {
+        for (int r = 0; r < ITERATIONS; ++r) {
+            for (const auto& pod: registry) {
+                sink += pod->getCpuRequest();
+            }
+        }
+    });
+
+    // --- lookup by name
+    size_t found = 0;
+    const double plainFind = seconds([&]() {
+        for (const auto& name: names) {
+            found += find_if(plain.begin(), plain.end(),
+                             [&](const unique_ptr<Pod>& p) { return p->getName() == name; }) != plain.end();
+        }
+    });
+    const double registryFind = seconds([&]() {
+        for (const auto& name: names) {
+            found += registry.find(name) != nullptr;
+        }
+    });
+
+    // --- removal by name
+    const double plainRemove = seconds([&]() {
+        for (const auto& name: names) {
+            auto it = find_if(plain.begin(), plain.end(),
+                              [&](const unique_ptr<Pod>& p) { return p->getName() == name; });
+            plain.erase(it);
+        }
+    });
+    const double registryRemove = seconds([&]() {
+        for (const auto& name: names) {
+            registry.remove(name);
+        }
+    });
+
+    const double pods = PODS, perPass = PODS * static_cast<double>(ITERATIONS);
+    cout << fixed << setprecision(1);
+    cout << "pods: " << PODS << " (1-3 containers, " << podBytes / pods << " heap bytes/pod), "
+         << names.size() << " lookups/removals\n";
+    cout << "                     vector      registry\n";
+    cout << "storage bytes/pod  " << setw(9) << plainBytes / pods << "   " << setw(9) << registryBytes / pods << "\n";
+    cout << "insert ns/pod      " << setw(9) << plainInsert * 1e9 / pods << "   " << setw(9) << registryInsert * 1e9 / pods << "\n";
+    cout << "iterate ns/pod     " << setw(9) << plainIter * 1e9 / perPass << "   " << setw(9) << registryIter * 1e9 / perPass << "\n";
+    cout << "find us/op         " << setw(9) << plainFind * 1e6 / names.size() << "   " << setw(9) << registryFind * 1e6 / names.size() << "\n";
+    cout << "remove us/op       " << setw(9) << plainRemove * 1e6 / names.size() << "   " << setw(9) << registryRemove * 1e6 / names.size() << "\n";
+    cout << "(checksum " << sink + found << ")\n";
+    return 0;
+}
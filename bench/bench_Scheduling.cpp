@@ -0,0 +1,55 @@
+// Hot path of KubernetesCluster::schedulePod. Build once with and once without
+// -DCLOUDSIM_INSTRUMENTATION=ON/OFF and compare the ns/pod lines : the
+// instrumented build must stay within 2% of the bare one. Run the two binaries
+// alternately a few times : a single run is noisier than that.
+#include "Instrumentation.hpp"
+#include "KubernetesCluster.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+static const int SERVERS = 64;
+static const int PODS = 200000;
+static const int RUNS = 7;
+
+static double runOnce() {
+    KubernetesCluster cluster("bench");
+    for (int n = 0; n < SERVERS; ++n) {
+        cluster.addServer(make_shared<Server>("n" + to_string(n), 256.0, 512.0));
+    }
+
+    vector<unique_ptr<Pod>> pods;
+    pods.reserve(PODS);
+    for (int i = 0; i < PODS; ++i) {
+        auto pod = make_unique<Pod>("pod-" + to_string(i));
+        pod->addContainer(make_unique<Container>("app", 0.05, 0.1, "img"));
+        pod->addContainer(make_unique<Container>("sidecar", 0.01, 0.02, "img"));
+        pods.push_back(move(pod));
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (auto& pod: pods) {
+        cluster.schedulePod(pod);
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(end - start).count() / PODS;
+}
+
+int main() {
+    cout << "instrumentation: " << (Instrumentation::compiledIn() ? "ON" : "OFF") << "\n";
+
+    vector<double> samples;
+    for (int run = 0; run < RUNS; ++run) {
+        samples.push_back(runOnce());
+    }
+    sort(samples.begin(), samples.end());
+    cout << fixed << setprecision(1)
+         << "schedulePod ns/pod: best=" << samples.front()
+         << " median=" << samples[samples.size() / 2] << "\n";
+
+    if (Instrumentation::compiledIn()) {
+        cout << Instrumentation::collect().toString();
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+"""Reader for the columnar files written by cloudsim (format documented in src/ColumnarWriter.hpp).
+
+    from cloudsim_columns import read_table
+    servers = read_table("export_servers.col")
+
+The file is memory-mapped and numeric columns are numpy views on it : a file
+written as a single batch is loaded without copying. Several batches are
+concatenated (one copy). String columns become pandas Categoricals built from
+the dictionary codes.
+"""
+import mmap
+import struct
+
+import numpy as np
+import pandas as pd
+
+MAGIC = b"CSIMCOL1"
+FLOAT64, INT64, STRING = 0, 1, 2
+_DTYPES = {FLOAT64: np.dtype("<f8"), INT64: np.dtype("<i8"), STRING: np.dtype("<i4")}
+
+
+def _align(pos):
+    return (pos + 7) & ~7
+
+
+def read_columns(path):
+    """Returns (schema, columns) : [(name, type)] and {name: numpy array or Categorical}."""
+    with open(path, "rb") as f:
+        buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+    if buf[:8] != MAGIC:
+        raise ValueError(f"{path}: not a cloudsim columnar file")
+    version, count = struct.unpack_from("<II", buf, 8)
+    if version != 1:
+        raise ValueError(f"{path}: unsupported version {version}")
+
+    pos = 16
+    schema = []
+    for _ in range(count):
+        ctype, _, length = struct.unpack_from("<BBH", buf, pos)
+        pos += 4
+        schema.append((bytes(buf[pos:pos + length]).decode(), ctype))
+        pos += length
+    pos = _align(pos)
+
+    chunks = {name: [] for name, _ in schema}
+    dictionaries = {name: [] for name, ctype in schema if ctype == STRING}
+    while True:
+        (rows,) = struct.unpack_from("<Q", buf, pos)
+        pos += 8
+        if rows == 0:
+            (total,) = struct.unpack_from("<Q", buf, pos)
+            break
+        for name, ctype in schema:
+            if ctype != STRING:
+                continue
+            (fresh,) = struct.unpack_from("<I", buf, pos)
+            pos += 4
+            for _ in range(fresh):
+                (length,) = struct.unpack_from("<I", buf, pos)
+                pos += 4
+                dictionaries[name].append(bytes(buf[pos:pos + length]).decode())
+                pos += length
+        pos = _align(pos)
+        for name, ctype in schema:
+            dtype = _DTYPES[ctype]
+            chunks[name].append(np.frombuffer(buf, dtype=dtype, count=rows, offset=pos))
+            pos = _align(pos + rows * dtype.itemsize)
+
+    columns = {}
+    for name, ctype in schema:
+        parts = chunks[name]
+        if not parts:
+            values = np.empty(0, dtype=_DTYPES[ctype])
+        elif len(parts) == 1:
+            values = parts[0]
+        else:
+            values = np.concatenate(parts)
+        if ctype == STRING:
+            values = pd.Categorical.from_codes(values, categories=dictionaries[name])
+        columns[name] = values
+    if total != len(next(iter(columns.values()))):
+        raise ValueError(f"{path}: footer announces {total} rows")
+    return schema, columns
+
+
+def read_table(path):
+    """Loads a columnar file as a DataFrame (numeric columns are not copied)."""
+    _, columns = read_columns(path)
+    return pd.DataFrame(columns, copy=False)
+
+
+def read_cluster(prefix):
+    """Loads the tables written by exportCluster(cluster, prefix)."""
+    return {name: read_table(f"{prefix}{name}.col") for name in ("servers", "pods", "containers")}
@@ -0,0 +1,57 @@
+#ifndef BLOCKINGQUEUE_HPP
+#define BLOCKINGQUEUE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+using namespace std;
+
+// Bounded queue between two pipeline stages ; close() wakes everybody up
+template <typename T>
+class BlockingQueue {
+    private:
+        mutex lock_;
+        condition_variable notEmpty_;
+        condition_variable notFull_;
+        deque<T> items_;
+        size_t capacity_;
+        bool closed_;
+
+    public:
+        explicit BlockingQueue(size_t capacity)
+            : capacity_(capacity), closed_(false) {}
+
+        // Returns false if the queue was closed
+        bool push(T item) {
+            unique_lock<mutex> guard(lock_);
+            notFull_.wait(guard, [&]() { return closed_ || items_.size() < capacity_; });
+            if (closed_) {
+                return false;
+            }
+            items_.push_back(move(item));
+            notEmpty_.notify_one();
+            return true;
+        }
+
+        // Returns false once the queue is closed and empty
+        bool pop(T& item) {
+            unique_lock<mutex> guard(lock_);
+            notEmpty_.wait(guard, [&]() { return closed_ || !items_.empty(); });
+            if (items_.empty()) {
+                return false;
+            }
+            item = move(items_.front());
+            items_.pop_front();
+            notFull_.notify_one();
+            return true;
+        }
+
+        void close() {
+            lock_guard<mutex> guard(lock_);
+            closed_ = true;
+            notEmpty_.notify_all();
+            notFull_.notify_all();
+        }
+};
+
+#endif
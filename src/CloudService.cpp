@@ -0,0 +1,380 @@
+#include "CloudService.hpp"
+#include "BlockingQueue.hpp"
+#include "Exceptions.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Batches travelling between the stages ; a few in flight are enough to overlap them
+const size_t PIPELINE_DEPTH = 8;
+const size_t READ_CHUNK = 64 * 1024;
+
+struct Response {
+    string line;
+    uint64_t receivedNs;
+};
+
+bool parseNumber(const string& token, double& value) {
+    if (token.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = strtod(token.c_str(), &end);
+    return end == token.c_str() + token.size() && value >= 0.0;
+}
+
+// On a socket, send() with MSG_NOSIGNAL : a client gone away is an EPIPE error, not a SIGPIPE
+void writeAll(int fd, bool isSocket, const string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = isSocket ? ::send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL)
+                           : ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw FileException("CloudService: write failed: " + string(strerror(errno)));
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+}
+
+string ServiceStats::toString() const {
+    ostringstream oss;
+    oss << "requests=" << requests << " batches=" << batches
+        << " rps=" << static_cast<uint64_t>(requestsPerSecond)
+        << " p50_us=" << p50Ns / 1000 << " p99_us=" << p99Ns / 1000
+        << " max_us=" << maxNs / 1000;
+    return oss.str();
+}
+
+CloudService::CloudService(const string& clusterName)
+    : cluster_(clusterName),
+        queue_(cluster_),
+        shutdown_(false),
+        requests_(0),
+        batches_(0),
+        firstNs_(0),
+        lastNs_(0) {}
+
+ServiceRequest CloudService::parse(const string& line) {
+    ServiceRequest request;
+    istringstream in(line);
+    string verb;
+    in >> verb;
+
+    if (verb == "add-server") {
+        string cpu, mem;
+        in >> request.name >> cpu >> mem;
+        if (request.name.empty() || !parseNumber(cpu, request.cpu) || !parseNumber(mem, request.mem)) {
+            request.error = "usage: add-server <id> <cpu> <mem>";
+            return request;
+        }
+        request.kind = ServiceRequest::Kind::AddServer;
+    } else if (verb == "schedule") {
+        in >> request.name;
+        if (request.name.empty()) {
+            request.error = "usage: schedule <pod> <cpu>:<mem>[:<image>] ...";
+            return request;
+        }
+        auto pod = make_unique<Pod>(request.name);
+        string spec;
+        size_t index = 0;
+        while (in >> spec) {
+            // <cpu>:<mem>[:<image>]
+            const size_t first = spec.find(':');
+            const size_t second = first == string::npos ? string::npos : spec.find(':', first + 1);
+            double cpu = 0.0, mem = 0.0;
+            if (first == string::npos
+                || !parseNumber(spec.substr(0, first), cpu)
+                || !parseNumber(spec.substr(first + 1, second == string::npos ? string::npos : second - first - 1), mem)) {
+                request.error = "invalid container spec: " + spec;
+                return request;
+            }
+            const string image = second == string::npos ? "default" : spec.substr(second + 1);
+            pod->addContainer(make_unique<Container>(request.name + "-c" + to_string(index++), cpu, mem, image));
+        }
+        if (index == 0) {
+            request.error = "schedule: a pod needs at least one container";
+            return request;
+        }
+        request.pod = move(pod);
+        request.kind = ServiceRequest::Kind::Schedule;
+    } else if (verb == "evict") {
+        in >> request.name;
+        if (request.name.empty()) {
+            request.error = "usage: evict <pod>";
+            return request;
+        }
+        request.kind = ServiceRequest::Kind::Evict;
+    } else if (verb == "query") {
+        string what;
+        in >> what >> request.name;
+        if (what == "cluster") {
+            request.kind = ServiceRequest::Kind::QueryCluster;
+        } else if (what == "pod" && !request.name.empty()) {
+            request.kind = ServiceRequest::Kind::QueryPod;
+        } else if (what == "server" && !request.name.empty()) {
+            request.kind = ServiceRequest::Kind::QueryServer;
+        } else {
+            request.error = "usage: query cluster | query pod <pod> | query server <id>";
+        }
+    } else if (verb == "stats") {
+        request.kind = ServiceRequest::Kind::Stats;
+    } else if (verb == "quit") {
+        request.kind = ServiceRequest::Kind::Quit;
+    } else if (verb == "shutdown") {
+        request.kind = ServiceRequest::Kind::Shutdown;
+    } else {
+        request.error = "unknown request: " + verb;
+    }
+    return request;
+}
+
+Server* CloudService::findServer(const string& id) {
+    for (auto& node: cluster_.getNodes()) {
+        if (node->getId() == id) {
+            return node.get();
+        }
+    }
+    return nullptr;
+}
+
+string CloudService::placementOf(const string& pod) {
+    if (const Pod* placed = cluster_.getPods().find(pod)) {
+        return "ok " + placed->getNode();
+    }
+    if (queue_.contains(pod)) {
+        return "pending";
+    }
+    return "error unknown pod " + pod;
+}
+
+string CloudService::execute(ServiceRequest& request) {
+    try {
+        switch (request.kind) {
+            case ServiceRequest::Kind::AddServer:
+                if (findServer(request.name) != nullptr) {
+                    return "error server " + request.name + " already exists";
+                }
+                cluster_.addServer(make_shared<Server>(request.name, request.cpu, request.mem));
+                return "ok";
+
+            case ServiceRequest::Kind::Schedule: {
+                const string name = request.name;
+                if (queue_.submit(request.pod)) {
+                    return "ok " + cluster_.getPods().find(name)->getNode();
+                }
+                return "pending";
+            }
+
+            case ServiceRequest::Kind::Evict:
+                if (queue_.remove(request.name) == nullptr) {
+                    cluster_.evictPod(request.name);
+                }
+                return "ok";
+
+            case ServiceRequest::Kind::QueryCluster: {
+                double freeCpu = 0.0, freeMem = 0.0;
+                for (const auto& node: cluster_.getNodes()) {
+                    freeCpu += node->getAvailableCpu();
+                    freeMem += node->getAvailableMem();
+                }
+                ostringstream oss;
+                oss << "ok nodes=" << cluster_.getNodes().size() << " pods=" << cluster_.getPods().size()
+                    << " pending=" << queue_.depth() << " free_cpu=" << freeCpu << " free_mem=" << freeMem;
+                return oss.str();
+            }
+
+            case ServiceRequest::Kind::QueryPod:
+                return placementOf(request.name);
+
+            case ServiceRequest::Kind::QueryServer: {
+                Server* server = findServer(request.name);
+                if (server == nullptr) {
+                    return "error unknown server " + request.name;
+                }
+                ostringstream oss;
+                oss << "ok cpu=" << server->getAvailableCpu() << " mem=" << server->getAvailableMem();
+                return oss.str();
+            }
+
+            case ServiceRequest::Kind::Stats:
+                return "ok " + getStats().toString();
+
+            case ServiceRequest::Kind::Quit:
+                return "ok";
+
+            case ServiceRequest::Kind::Shutdown:
+                shutdown_ = true;
+                return "ok";
+
+            case ServiceRequest::Kind::Invalid:
+            default:
+                return "error " + request.error;
+        }
+    } catch (const CloudException& e) {
+        return string("error ") + e.what();
+    }
+}
+
+void CloudService::serve(int inFd, int outFd) {
+    BlockingQueue<vector<ServiceRequest>> parsed(PIPELINE_DEPTH);
+    BlockingQueue<vector<Response>> answered(PIPELINE_DEPTH);
+
+    // Stage 1 : read and parse, every read() gives one batch
+    thread reader([&]() {
+        string pendingBytes;
+        vector<char> chunk(READ_CHUNK);
+        bool done = false;
+        while (!done) {
+            ssize_t n = ::read(inFd, chunk.data(), chunk.size());
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            const uint64_t now = Instrumentation::nowNs();
+            pendingBytes.append(chunk.data(), static_cast<size_t>(n));
+
+            vector<ServiceRequest> batch;
+            size_t start = 0;
+            size_t end;
+            while (!done && (end = pendingBytes.find('\n', start)) != string::npos) {
+                string line = pendingBytes.substr(start, end - start);
+                start = end + 1;
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                if (line.empty()) {
+                    continue;
+                }
+                batch.push_back(parse(line));
+                batch.back().receivedNs = now;
+                const auto kind = batch.back().kind;
+                done = kind == ServiceRequest::Kind::Quit || kind == ServiceRequest::Kind::Shutdown;
+            }
+            pendingBytes.erase(0, start);
+            if (!batch.empty() && !parsed.push(move(batch))) {
+                break;
+            }
+        }
+        parsed.close();
+    });
+
+    // Stage 2 : the cluster is only touched by this thread
+    thread scheduler([&]() {
+        vector<ServiceRequest> batch;
+        while (parsed.pop(batch)) {
+            vector<Response> responses;
+            responses.reserve(batch.size());
+            for (auto& request: batch) {
+                responses.push_back({execute(request), request.receivedNs});
+            }
+            if (!answered.push(move(responses))) {
+                break;
+            }
+        }
+        answered.close();
+    });
+
+    // Stage 3 : one write per batch, then the latency of each request
+    struct stat info;
+    const bool isSocket = ::fstat(outFd, &info) == 0 && S_ISSOCK(info.st_mode);
+    vector<Response> responses;
+    string out;
+    try {
+        while (answered.pop(responses)) {
+            out.clear();
+            for (const auto& r: responses) {
+                out += r.line;
+                out += '\n';
+            }
+            writeAll(outFd, isSocket, out);
+
+            const uint64_t now = Instrumentation::nowNs();
+            lock_guard<mutex> guard(statsLock_);
+            for (const auto& r: responses) {
+                latency_.record(now - r.receivedNs);
+                firstNs_ = firstNs_ == 0 ? r.receivedNs : min(firstNs_, r.receivedNs);
+            }
+            requests_ += responses.size();
+            ++batches_;
+            lastNs_ = now;
+        }
+    } catch (const FileException&) {
+        // The client went away : drain the pipeline so the other stages can stop
+        parsed.close();
+        answered.close();
+    }
+    reader.join();
+    scheduler.join();
+}
+
+void CloudService::serveUnixSocket(const string& path) {
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw FileException("CloudService: socket() failed: " + string(strerror(errno)));
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        ::close(listener);
+        throw FileException("CloudService: socket path too long: " + path);
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    ::unlink(path.c_str());
+
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listener, 16) < 0) {
+        const string reason = strerror(errno);
+        ::close(listener);
+        throw FileException("CloudService: cannot listen on " + path + ": " + reason);
+    }
+
+    while (!shutdown_) {
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        serve(client, client);
+        ::close(client);
+    }
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+
+bool CloudService::isShutdown() const noexcept {
+    return shutdown_;
+}
+
+ServiceStats CloudService::getStats() const {
+    lock_guard<mutex> guard(statsLock_);
+    ServiceStats stats;
+    stats.requests = requests_;
+    stats.batches = batches_;
+    stats.seconds = lastNs_ > firstNs_ ? static_cast<double>(lastNs_ - firstNs_) / 1e9 : 0.0;
+    stats.requestsPerSecond = stats.seconds > 0.0 ? static_cast<double>(requests_) / stats.seconds : 0.0;
+    stats.p50Ns = latency_.percentile(50);
+    stats.p99Ns = latency_.percentile(99);
+    stats.maxNs = latency_.max();
+    return stats;
+}
+
+KubernetesCluster& CloudService::getCluster() noexcept {
+    return cluster_;
+}
@@ -0,0 +1,90 @@
+#ifndef CLOUDSERVICE_HPP
+#define CLOUDSERVICE_HPP
+
+#include "Instrumentation.hpp"
+#include "KubernetesCluster.hpp"
+#include "SchedulingQueue.hpp"
+#include <mutex>
+
+/*
+    Line protocol of the service (one request per line, one response line per request) :
+
+        add-server <id> <cpu> <mem>                 -> ok
+        schedule <pod> <cpu>:<mem>[:<image>] ...     -> ok <server> | pending
+        evict <pod>                                  -> ok (a pending pod is cancelled)
+        query cluster                                -> ok nodes=.. pods=.. pending=.. free_cpu=.. free_mem=..
+        query pod <pod>                              -> ok <server> | pending
+        query server <id>                            -> ok cpu=.. mem=..
+        stats                                        -> ok requests=.. rps=.. p50_us=.. p99_us=..
+        quit                                         -> ok (ends this input)
+        shutdown                                     -> ok (ends the socket server too)
+
+    Any failure is answered with "error <message>".
+*/
+struct ServiceRequest {
+    enum class Kind { AddServer, Schedule, Evict, QueryCluster, QueryPod, QueryServer, Stats, Quit, Shutdown, Invalid };
+
+    Kind kind = Kind::Invalid;
+    string name;              // server id or pod name
+    double cpu = 0.0;
+    double mem = 0.0;
+    unique_ptr<Pod> pod;      // built by the parsing stage for "schedule"
+    string error;             // why the line is Invalid
+    uint64_t receivedNs = 0;
+};
+
+struct ServiceStats {
+    size_t requests = 0;
+    size_t batches = 0;
+    double seconds = 0.0;
+    double requestsPerSecond = 0.0;
+    uint64_t p50Ns = 0;
+    uint64_t p99Ns = 0;
+    uint64_t maxNs = 0;
+
+    string toString() const;
+};
+
+/*
+    Persistent placement service. serve() runs a three-stage pipeline :
+
+        reader thread    : read() what is available, parse every complete line -> batch
+        scheduler thread : execute the batch on the cluster                      -> responses
+        calling thread   : one write() per batch, latency of each request recorded
+
+    The cluster stays in memory between connections, so callers pay neither
+    process startup nor a state reload.
+*/
+class CloudService {
+    private:
+        KubernetesCluster cluster_;
+        SchedulingQueue queue_;           // pods answered "pending" wait here
+        bool shutdown_;
+
+        mutable mutex statsLock_;
+        LatencyHistogram latency_;
+        size_t requests_;
+        size_t batches_;
+        uint64_t firstNs_;
+        uint64_t lastNs_;
+
+        Server* findServer(const string& id);
+        string placementOf(const string& pod);
+
+    public:
+        CloudService(const string& clusterName = "cloudsim");
+
+        static ServiceRequest parse(const string& line);
+        string execute(ServiceRequest& request);  // scheduler stage, one thread only
+
+        // Returns when the input is closed or a "quit" / "shutdown" line is read
+        void serve(int inFd, int outFd);
+        // Accepts connections one after the other until a "shutdown" request
+        void serveUnixSocket(const string& path);
+
+        bool isShutdown() const noexcept;
+        ServiceStats getStats() const;
+        KubernetesCluster& getCluster() noexcept;
+};
+
+#endif
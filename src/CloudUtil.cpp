@@ -1,4 +1,6 @@
 #include "CloudUtil.hpp"
+#include "Instrumentation.hpp"
+#include <fstream>
 
 void CloudUtil::display(const KubernetesCluster& cluster) {
     std::cout << cluster.getMetrics();
@@ -15,9 +17,26 @@ void CloudUtil::deployPods(KubernetesCluster& cluster, std::vector<std::unique_p
     }
 }
 
+void CloudUtil::deployPods(SchedulingQueue& queue, std::vector<std::unique_ptr<Pod>>& pods) {
+    for (auto& pod: pods) {
+        const std::string name = pod->getName();
+        try {
+            if (!queue.submit(pod)) {
+                std::cout << "Pod " << name << " pending: no server available yet" << std::endl;
+            }
+        } catch (const DuplicatePodException& e) {
+            std::cout << "Error deploying pod: " << e.what() << std::endl;
+        }
+    }
+}
 
-
-
-
-
-
+void CloudUtil::saveClusterMetrics(const KubernetesCluster& cluster, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw FileException("Cannot open this file :" + filename);
+    }
+    file << cluster.getMetrics();
+    if (Instrumentation::compiledIn()) {
+        file << Instrumentation::collect().toString();
+    }
+}
@@ -2,11 +2,14 @@
 #define CLOUDUTIL_HPP
 
 #include "KubernetesCluster.hpp"
+#include "SchedulingQueue.hpp"
 
 class CloudUtil {
     public:
         void display(const KubernetesCluster& cluster);
         void deployPods(KubernetesCluster& cluster, std::vector<std::unique_ptr<Pod>>& pods);
+        // Unschedulable pods are parked in the queue instead of being dropped
+        void deployPods(SchedulingQueue& queue, std::vector<std::unique_ptr<Pod>>& pods);
         void saveClusterMetrics(const KubernetesCluster& cluster, const std::string& filename);
 
 };
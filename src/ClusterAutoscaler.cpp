@@ -0,0 +1,326 @@
+#include "ClusterAutoscaler.hpp"
+#include "ClusterExport.hpp"
+#include "Exceptions.hpp"
+#include <algorithm>
+#include <queue>
+
+ClusterAutoscaler::ClusterAutoscaler(KubernetesCluster& cluster, AutoscalerConfig config, double now)
+    : cluster_(cluster),
+        config_(move(config)),
+        now_(now),
+        nodeCount_(0),
+        nextId_(0),
+        clusterCostPerSecond_(0.0),
+        nodeSeconds_(0.0),
+        cost_(0.0),
+        nodesAdded_(0),
+        nodesRemoved_(0)
+{
+    // One scan at attach time, everything after that comes from the events
+    for (const auto& node: cluster_.getNodes()) {
+        ++nodeCount_;
+        podsPerNode_[node->getId()] = 0;
+    }
+    for (const auto& pod: cluster_.getPods()) {
+        auto it = podsPerNode_.find(pod->getNode());
+        if (it != podsPerNode_.end()) {
+            ++it->second;
+        }
+    }
+    for (const auto& entry: podsPerNode_) {
+        if (entry.second == 0) {
+            markIdle(entry.first);
+        }
+    }
+    cluster_.addListener(this);
+}
+
+ClusterAutoscaler::~ClusterAutoscaler() {
+    cluster_.removeListener(this);
+}
+
+void ClusterAutoscaler::markIdle(const string& id) {
+    idleSince_[id] = now_;
+    idleOrder_.insert({now_, id});
+}
+
+void ClusterAutoscaler::markBusy(const string& id) {
+    auto it = idleSince_.find(id);
+    if (it == idleSince_.end()) {
+        return;
+    }
+    idleOrder_.erase({it->second, id});
+    idleSince_.erase(it);
+}
+
+ScaleDecision ClusterAutoscaler::tick(double now, const vector<unique_ptr<Pod>>& pending) {
+    ScaleDecision decision;
+
+    // Accounting for the time elapsed since the last tick
+    const double dt = max(0.0, now - now_);
+    nodeSeconds_ += static_cast<double>(nodeCount_) * dt;
+    cost_ += clusterCostPerSecond_ * dt;
+    now_ = now;
+
+    // Servers ordered earlier that are now ready ; their capacity is free for the pending pods
+    vector<pair<double, double>> fresh;
+    while (!provisioning_.empty() && provisioning_.front().readyAt <= now_) {
+        Provision p = move(provisioning_.front());
+        provisioning_.pop_front();
+        costPerSecond_[p.id] = p.shape.costPerHour / 3600.0;
+        cluster_.addServer(make_shared<Server>(p.id, p.shape.cpu, p.shape.mem));
+        fresh.emplace_back(p.shape.cpu, p.shape.mem);
+        ++decision.added;
+        ++nodesAdded_;
+    }
+
+    decision.requested = scaleUp(pending, move(fresh));
+    decision.removed = scaleDown();
+    return decision;
+}
+
+size_t ClusterAutoscaler::scaleUp(const vector<unique_ptr<Pod>>& pending, vector<pair<double, double>> bins) {
+    if (pending.empty() || config_.templates.empty()) {
+        return 0;
+    }
+
+    // Capacity already on its way also counts, so the same pods never order twice
+    for (const auto& p: provisioning_) {
+        bins.emplace_back(p.shape.cpu, p.shape.mem);
+    }
+
+    vector<pair<double, double>> demands;
+    demands.reserve(pending.size());
+    for (const auto& pod: pending) {
+        demands.emplace_back(pod->getCpuRequest(), pod->getMemRequest());
+    }
+    // First fit decreasing : the big pods first
+    sort(demands.begin(), demands.end(), greater<pair<double, double>>());
+
+    size_t requested = 0;
+    for (const auto& d: demands) {
+        bool placed = false;
+        for (auto& bin: bins) {
+            if (d.first <= bin.first && d.second <= bin.second) {
+                bin.first -= d.first;
+                bin.second -= d.second;
+                placed = true;
+                break;
+            }
+        }
+        if (placed) {
+            continue;
+        }
+
+        // Cheapest template able to hold the pod
+        const NodeTemplate* best = nullptr;
+        for (const auto& t: config_.templates) {
+            if (d.first <= t.cpu && d.second <= t.mem && (best == nullptr || t.costPerHour < best->costPerHour)) {
+                best = &t;
+            }
+        }
+        if (best == nullptr) {
+            continue;  // no template can ever run this pod
+        }
+        if (nodeCount_ + provisioning_.size() >= config_.maxNodes) {
+            break;
+        }
+
+        provisioning_.push_back({now_ + config_.provisionDelay, best->prefix + "-" + to_string(++nextId_), *best});
+        bins.emplace_back(best->cpu - d.first, best->mem - d.second);
+        ++requested;
+    }
+    return requested;
+}
+
+size_t ClusterAutoscaler::scaleDown() {
+    size_t removed = 0;
+    while (!idleOrder_.empty() && nodeCount_ > config_.minNodes) {
+        const auto& oldest = *idleOrder_.begin();
+        if (oldest.first + config_.scaleDownCooldown > now_) {
+            break;
+        }
+        const string id = oldest.second;
+        cluster_.removeServer(id);  // onServerRemoved() drops it from the idle set
+        ++removed;
+        ++nodesRemoved_;
+    }
+    return removed;
+}
+
+void ClusterAutoscaler::onServerAdded(const Server& server) {
+    ++nodeCount_;
+    podsPerNode_[server.getId()] = server.getPodCount();
+    clusterCostPerSecond_ += costPerSecond_[server.getId()];
+    if (server.getPodCount() == 0) {
+        markIdle(server.getId());
+    }
+}
+
+void ClusterAutoscaler::onServerRemoved(const Server& server) {
+    --nodeCount_;
+    markBusy(server.getId());
+    podsPerNode_.erase(server.getId());
+    auto it = costPerSecond_.find(server.getId());
+    if (it != costPerSecond_.end()) {
+        clusterCostPerSecond_ -= it->second;
+        costPerSecond_.erase(it);
+    }
+}
+
+void ClusterAutoscaler::onPodScheduled(const Pod&, const Server& server) {
+    if (podsPerNode_[server.getId()]++ == 0) {
+        markBusy(server.getId());
+    }
+}
+
+void ClusterAutoscaler::onPodEvicted(const Pod&, const Server& server) {
+    auto it = podsPerNode_.find(server.getId());
+    if (it != podsPerNode_.end() && it->second > 0 && --it->second == 0) {
+        markIdle(server.getId());
+    }
+}
+
+double ClusterAutoscaler::getNow() const noexcept {
+    return now_;
+}
+
+double ClusterAutoscaler::getNodeSeconds() const noexcept {
+    return nodeSeconds_;
+}
+
+double ClusterAutoscaler::getCost() const noexcept {
+    return cost_;
+}
+
+size_t ClusterAutoscaler::getNodesAdded() const noexcept {
+    return nodesAdded_;
+}
+
+size_t ClusterAutoscaler::getNodesRemoved() const noexcept {
+    return nodesRemoved_;
+}
+
+size_t ClusterAutoscaler::getProvisioning() const noexcept {
+    return provisioning_.size();
+}
+
+size_t ClusterAutoscaler::getIdleNodes() const noexcept {
+    return idleOrder_.size();
+}
+
+/*
+    Simulation loop, every `step` seconds :
+        finished pods --> evicted
+        new arrivals  --> scheduled, or pending
+        capacity freed / added --> pending pods retried
+        autoscaler tick
+*/
+SimulationReport simulateAutoscaler(KubernetesCluster& cluster, const AutoscalerConfig& config,
+                                    vector<TraceEntry>& trace, double step,
+                                    UtilizationRecorder* recorder) {
+    // The clock must move forward, or the loop below never ends
+    if (!(step > 0.0)) {
+        throw CloudException("simulateAutoscaler : le pas doit etre positif");
+    }
+    SimulationReport report;
+    double now = trace.empty() ? 0.0 : trace.front().arrival;
+    ClusterAutoscaler scaler(cluster, config, now);
+
+    using Finish = pair<double, string>;  // (end time, pod name)
+    priority_queue<Finish, vector<Finish>, greater<Finish>> running;
+
+    vector<unique_ptr<Pod>> pending;
+    vector<size_t> pendingEntry;  // trace index of pending[i]
+    vector<size_t> duplicates;    // trace index of the pods left out, their name was taken
+    double totalWait = 0.0;
+
+    // Returns false if the pod must stay pending. A duplicate name is no demand for
+    // a new server : the pod goes back to its entry and is never retried
+    auto tryPlace = [&](unique_ptr<Pod>& pod, size_t entry, double at) {
+        const TraceEntry& e = trace[entry];
+        const string name = pod->getName();
+        try {
+            cluster.schedulePod(pod);
+        } catch (const DuplicatePodException&) {
+            if (&pod != &trace[entry].pod) {
+                trace[entry].pod = move(pod);
+            }
+            duplicates.push_back(entry);
+            return true;
+        } catch (const AllocationException&) {
+            return false;
+        }
+        running.push({at + e.duration, name});
+        totalWait += at - e.arrival;
+        report.maxWait = max(report.maxWait, at - e.arrival);
+        ++report.podsScheduled;
+        return true;
+    };
+
+    auto retryPending = [&](double at) {
+        size_t kept = 0;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (!tryPlace(pending[i], pendingEntry[i], at)) {
+                pending[kept] = move(pending[i]);
+                pendingEntry[kept] = pendingEntry[i];
+                ++kept;
+            }
+        }
+        pending.resize(kept);
+        pendingEntry.resize(kept);
+    };
+
+    size_t next = 0;
+    while (true) {
+        bool capacityChanged = false;
+
+        while (!running.empty() && running.top().first <= now) {
+            cluster.evictPod(running.top().second);
+            running.pop();
+            capacityChanged = true;
+        }
+        if (capacityChanged) {
+            retryPending(now);
+        }
+
+        while (next < trace.size() && trace[next].arrival <= now) {
+            if (!tryPlace(trace[next].pod, next, now)) {
+                pending.push_back(move(trace[next].pod));
+                pendingEntry.push_back(next);
+            }
+            ++next;
+        }
+
+        ScaleDecision decision = scaler.tick(now, pending);
+        if (decision.added > 0) {
+            retryPending(now);
+        }
+        report.peakNodes = max(report.peakNodes, cluster.getNodes().size());
+        if (recorder != nullptr) {
+            recorder->record(now, cluster);
+        }
+
+        // Stop once the trace is over and the empty servers have been scaled down
+        const bool idle = next == trace.size() && running.empty() && scaler.getProvisioning() == 0;
+        const bool drained = scaler.getIdleNodes() == 0 || cluster.getNodes().size() <= config.minNodes;
+        if (idle && drained && (pending.empty() || decision.requested == 0)) {
+            break;
+        }
+        now += step;
+    }
+
+    report.duration = now - (trace.empty() ? 0.0 : trace.front().arrival);
+    report.cost = scaler.getCost();
+    report.nodeSeconds = scaler.getNodeSeconds();
+    report.podsUnscheduled = pending.size() + duplicates.size();
+    report.meanWait = report.podsScheduled > 0 ? totalWait / static_cast<double>(report.podsScheduled) : 0.0;
+    report.nodesAdded = scaler.getNodesAdded();
+    report.nodesRemoved = scaler.getNodesRemoved();
+
+    // Give the unscheduled pods back to the trace so the caller keeps ownership
+    for (size_t i = 0; i < pending.size(); ++i) {
+        trace[pendingEntry[i]].pod = move(pending[i]);
+    }
+    return report;
+}
@@ -0,0 +1,123 @@
+#ifndef CLUSTERAUTOSCALER_HPP
+#define CLUSTERAUTOSCALER_HPP
+
+#include "KubernetesCluster.hpp"
+#include <deque>
+#include <set>
+
+class UtilizationRecorder;  // ClusterExport.hpp
+
+// Shape of the servers the autoscaler is allowed to create
+struct NodeTemplate {
+    string prefix;       // new servers are named prefix-1, prefix-2, ...
+    double cpu;
+    double mem;
+    double costPerHour;
+};
+
+struct AutoscalerConfig {
+    vector<NodeTemplate> templates;
+    double provisionDelay = 60.0;      // seconds between the decision and the server being ready
+    double scaleDownCooldown = 600.0;  // seconds a server must stay empty before removal
+    size_t minNodes = 0;
+    size_t maxNodes = 100;
+};
+
+// What one tick() did
+struct ScaleDecision {
+    size_t requested = 0;  // servers ordered this tick
+    size_t added = 0;      // ordered servers that became ready this tick
+    size_t removed = 0;    // idle servers removed this tick
+};
+
+/*
+    Cluster autoscaler driven by a simulated clock.
+
+    It listens to the cluster and keeps, per server, the number of pods and the
+    moment it became empty, so tick() only looks at :
+        - the pending pods           -> scale up from the templates
+        - the oldest empty servers   -> scale down after the cooldown
+    and never rescans the whole cluster.
+*/
+class ClusterAutoscaler : public ClusterListener {
+    private:
+        struct Provision {
+            double readyAt;
+            string id;
+            NodeTemplate shape;
+        };
+
+        KubernetesCluster& cluster_;
+        AutoscalerConfig config_;
+        double now_;
+
+        size_t nodeCount_;
+        size_t nextId_;
+        deque<Provision> provisioning_;          // readyAt is increasing (constant delay)
+        unordered_map<string, size_t> podsPerNode_;
+        unordered_map<string, double> idleSince_;
+        set<pair<double, string>> idleOrder_;    // (idle since, id), oldest first
+        unordered_map<string, double> costPerSecond_;
+        double clusterCostPerSecond_;
+
+        // Accounting
+        double nodeSeconds_;
+        double cost_;
+        size_t nodesAdded_;
+        size_t nodesRemoved_;
+
+        void markIdle(const string& id);
+        void markBusy(const string& id);
+        size_t scaleUp(const vector<unique_ptr<Pod>>& pending, vector<pair<double, double>> bins);
+        size_t scaleDown();
+
+    public:
+        ClusterAutoscaler(KubernetesCluster& cluster, AutoscalerConfig config, double now = 0.0);
+        ~ClusterAutoscaler() override;
+
+        ScaleDecision tick(double now, const vector<unique_ptr<Pod>>& pending);
+
+        void onServerAdded(const Server& server) override;
+        void onServerRemoved(const Server& server) override;
+        void onPodScheduled(const Pod& pod, const Server& server) override;
+        void onPodEvicted(const Pod& pod, const Server& server) override;
+
+        // Getters
+        double getNow() const noexcept;
+        double getNodeSeconds() const noexcept;
+        double getCost() const noexcept;
+        size_t getNodesAdded() const noexcept;
+        size_t getNodesRemoved() const noexcept;
+        size_t getProvisioning() const noexcept;
+        size_t getIdleNodes() const noexcept;
+};
+
+// One pod of a trace : arrives at `arrival`, runs for `duration` seconds once placed
+struct TraceEntry {
+    double arrival;
+    double duration;
+    unique_ptr<Pod> pod;
+};
+
+struct SimulationReport {
+    double duration = 0.0;
+    double cost = 0.0;
+    double nodeSeconds = 0.0;
+    size_t podsScheduled = 0;
+    size_t podsUnscheduled = 0;   // still pending at the end of the trace
+    double meanWait = 0.0;        // seconds between arrival and placement
+    double maxWait = 0.0;
+    size_t peakNodes = 0;
+    size_t nodesAdded = 0;
+    size_t nodesRemoved = 0;
+};
+
+// Replays a trace (sorted by arrival, unique pod names) on the cluster, advancing the clock
+// by `step` seconds. Pods still pending at the end are left in their TraceEntry, so are the pods
+// whose name is already in the cluster : they count as unscheduled and never scale the cluster up.
+// If a recorder is given, server usage is recorded at every step. A step <= 0 throws CloudException.
+SimulationReport simulateAutoscaler(KubernetesCluster& cluster, const AutoscalerConfig& config,
+                                    vector<TraceEntry>& trace, double step,
+                                    UtilizationRecorder* recorder = nullptr);
+
+#endif
@@ -0,0 +1,96 @@
+#include "ClusterExport.hpp"
+
+uint64_t exportCluster(const KubernetesCluster& cluster, const string& prefix, size_t batchRows) {
+    ColumnarWriter servers(prefix + "servers.col", {
+        {"id", ColumnType::String},
+        {"initial_cpu", ColumnType::Float64},
+        {"initial_mem", ColumnType::Float64},
+        {"available_cpu", ColumnType::Float64},
+        {"available_mem", ColumnType::Float64},
+        {"pods", ColumnType::Int64},
+    }, batchRows);
+    for (const auto& node: cluster.getNodes()) {
+        servers.addString(node->getId())
+            .addFloat(node->getInitialCpu())
+            .addFloat(node->getInitialMem())
+            .addFloat(node->getAvailableCpu())
+            .addFloat(node->getAvailableMem())
+            .addInt(static_cast<int64_t>(node->getPodCount()))
+            .endRow();
+    }
+    servers.close();
+
+    ColumnarWriter pods(prefix + "pods.col", {
+        {"name", ColumnType::String},
+        {"node", ColumnType::String},
+        {"containers", ColumnType::Int64},
+        {"cpu_request", ColumnType::Float64},
+        {"mem_request", ColumnType::Float64},
+    }, batchRows);
+    ColumnarWriter containers(prefix + "containers.col", {
+        {"pod", ColumnType::String},
+        {"id", ColumnType::String},
+        {"image", ColumnType::String},
+        {"cpu", ColumnType::Float64},
+        {"mem", ColumnType::Float64},
+    }, batchRows);
+    for (const auto& pod: cluster.getPods()) {
+        const string& name = pod->getName();
+        pods.addString(name)
+            .addString(pod->getNode())
+            .addInt(static_cast<int64_t>(pod->getContainers().size()))
+            .addFloat(pod->getCpuRequest())
+            .addFloat(pod->getMemRequest())
+            .endRow();
+        for (const auto& c: pod->getContainers()) {
+            containers.addString(name)
+                .addString(c->getId())
+                .addString(c->getImage())
+                .addFloat(c->getCpu())
+                .addFloat(c->getMem())
+                .endRow();
+        }
+    }
+    pods.close();
+    containers.close();
+
+    return servers.getBytes() + pods.getBytes() + containers.getBytes();
+}
+
+UtilizationRecorder::UtilizationRecorder(const string& filename, size_t batchRows)
+    : writer_(filename, {
+        {"time", ColumnType::Float64},
+        {"node", ColumnType::String},
+        {"cpu_used", ColumnType::Float64},
+        {"mem_used", ColumnType::Float64},
+        {"cpu_util", ColumnType::Float64},
+        {"mem_util", ColumnType::Float64},
+        {"pods", ColumnType::Int64},
+    }, batchRows) {}
+
+void UtilizationRecorder::record(double time, const KubernetesCluster& cluster) {
+    for (const auto& node: cluster.getNodes()) {
+        const double cpuUsed = node->getInitialCpu() - node->getAvailableCpu();
+        const double memUsed = node->getInitialMem() - node->getAvailableMem();
+        writer_.addFloat(time)
+            .addString(node->getId())
+            .addFloat(cpuUsed)
+            .addFloat(memUsed)
+            .addFloat(node->getInitialCpu() > 0.0 ? cpuUsed / node->getInitialCpu() : 0.0)
+            .addFloat(node->getInitialMem() > 0.0 ? memUsed / node->getInitialMem() : 0.0)
+            .addInt(static_cast<int64_t>(node->getPodCount()))
+            .endRow();
+    }
+}
+
+void UtilizationRecorder::close() {
+    writer_.close();
+}
+
+size_t UtilizationRecorder::getRows() const noexcept {
+    return writer_.getRows();
+}
+
+uint64_t UtilizationRecorder::getBytes() const noexcept {
+    return writer_.getBytes();
+}
@@ -0,0 +1,35 @@
+#ifndef CLUSTEREXPORT_HPP
+#define CLUSTEREXPORT_HPP
+
+#include "ColumnarWriter.hpp"
+#include "KubernetesCluster.hpp"
+
+/*
+    Tables written by exportCluster (prefix + name) :
+
+        servers.col      id, initial_cpu, initial_mem, available_cpu, available_mem, pods
+        pods.col         name, node, containers, cpu_request, mem_request
+        containers.col   pod, id, image, cpu, mem
+
+    Returns the number of bytes written.
+*/
+uint64_t exportCluster(const KubernetesCluster& cluster, const string& prefix,
+                       size_t batchRows = ColumnarWriter::DEFAULT_BATCH_ROWS);
+
+// Time series of server usage : one row per server and per record() call
+//     time, node, cpu_used, mem_used, cpu_util, mem_util, pods
+class UtilizationRecorder {
+    private:
+        ColumnarWriter writer_;
+
+    public:
+        UtilizationRecorder(const string& filename, size_t batchRows = ColumnarWriter::DEFAULT_BATCH_ROWS);
+
+        void record(double time, const KubernetesCluster& cluster);
+        void close();
+
+        size_t getRows() const noexcept;
+        uint64_t getBytes() const noexcept;
+};
+
+#endif
@@ -0,0 +1,202 @@
+#include "ClusterFederation.hpp"
+#include "Exceptions.hpp"
+#include <exception>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+
+bool ShardSummary::mayFit(double cpu, double mem) const noexcept {
+    // Necessary condition only : the free capacity may be split over several servers
+    return cpu <= freeCpu && mem <= freeMem;
+}
+
+void ClusterFederation::SummaryListener::onServerAdded(const Server& server) {
+    summary.freeCpu += server.getAvailableCpu();
+    summary.freeMem += server.getAvailableMem();
+    ++summary.nodes;
+}
+
+void ClusterFederation::SummaryListener::onServerRemoved(const Server& server) {
+    summary.freeCpu -= server.getAvailableCpu();
+    summary.freeMem -= server.getAvailableMem();
+    --summary.nodes;
+}
+
+void ClusterFederation::SummaryListener::onPodScheduled(const Pod& pod, const Server&) {
+    summary.freeCpu -= pod.getCpuRequest();
+    summary.freeMem -= pod.getMemRequest();
+    ++summary.pods;
+}
+
+void ClusterFederation::SummaryListener::onPodEvicted(const Pod& pod, const Server&) {
+    summary.freeCpu += pod.getCpuRequest();
+    summary.freeMem += pod.getMemRequest();
+    --summary.pods;
+}
+
+ClusterFederation::ClusterFederation(ShardRouting routing)
+    : routing_(routing) {}
+
+ClusterFederation::~ClusterFederation() {
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        shards_[i]->removeListener(summaries_[i].get());
+    }
+}
+
+size_t ClusterFederation::addShard(const string& zone) {
+    if (zones_.count(zone) != 0) {
+        throw CloudException("Federation: la zone " + zone + " existe deja");
+    }
+    const size_t index = shards_.size();
+    shards_.push_back(make_unique<KubernetesCluster>(zone));
+    summaries_.push_back(make_unique<SummaryListener>());
+    shards_.back()->addListener(summaries_.back().get());
+    zones_[zone] = index;
+    return index;
+}
+
+void ClusterFederation::addServer(size_t shard, const shared_ptr<Server>& server) {
+    getShard(shard).addServer(server);
+}
+
+size_t ClusterFederation::hashShard(const string& name) const {
+    return hash<string>()(name) % shards_.size();
+}
+
+size_t ClusterFederation::route(const Pod& pod) const {
+    if (shards_.empty()) {
+        throw AllocationException("Federation: aucun shard");
+    }
+
+    size_t first = shards_.size();
+    if (routing_ == ShardRouting::Zone) {
+        auto label = pod.getLabels().find("zone");
+        if (label != pod.getLabels().end()) {
+            auto zone = zones_.find(label->second);
+            if (zone != zones_.end()) {
+                first = zone->second;
+            }
+        }
+    }
+    if (first == shards_.size()) {
+        first = hashShard(pod.getName());
+    }
+    return first;
+}
+
+size_t ClusterFederation::deployPods(vector<unique_ptr<Pod>>& pods) {
+    if (shards_.empty()) {
+        return 0;
+    }
+
+    const size_t n = shards_.size();
+    vector<vector<size_t>> batches(n);       // pod indexes given to each shard this round
+    vector<bool> tried(pods.size() * n, false);
+
+    // Names are checked before any pod reaches a shard thread : a pod named like a pod
+    // of any shard, or like an earlier pod of this batch, is not deployed
+    unordered_set<string> names;
+    for (size_t i = 0; i < pods.size(); ++i) {
+        if (pods[i] && names.insert(pods[i]->getName()).second && !contains(pods[i]->getName())) {
+            const size_t shard = route(*pods[i]);
+            batches[shard].push_back(i);
+            tried[i * n + shard] = true;
+        }
+    }
+
+    size_t scheduled = 0;
+    while (true) {
+        // Every shard schedules its batch in parallel ; refused pods come back in failed[shard]
+        vector<vector<size_t>> failed(n);
+        vector<size_t> placed(n, 0);
+        vector<exception_ptr> errors(n);
+        vector<thread> workers;
+        for (size_t s = 0; s < n; ++s) {
+            if (batches[s].empty()) {
+                continue;
+            }
+            workers.emplace_back([&, s]() {
+                // Nothing may escape the thread : other errors are rethrown after join
+                try {
+                    for (size_t i: batches[s]) {
+                        try {
+                            shards_[s]->schedulePod(pods[i]);
+                            ++placed[s];
+                        } catch (const AllocationException&) {
+                            failed[s].push_back(i);
+                        }
+                    }
+                } catch (...) {
+                    errors[s] = current_exception();
+                }
+            });
+        }
+        for (auto& worker: workers) {
+            worker.join();
+        }
+        for (const auto& error: errors) {
+            if (error) {
+                rethrow_exception(error);
+            }
+        }
+        for (size_t s = 0; s < n; ++s) {
+            scheduled += placed[s];
+            batches[s].clear();
+        }
+
+        // Spillover : best untried shard according to the summaries
+        bool spilled = false;
+        for (size_t s = 0; s < n; ++s) {
+            for (size_t i: failed[s]) {
+                const double cpu = pods[i]->getCpuRequest();
+                const double mem = pods[i]->getMemRequest();
+                size_t best = n;
+                for (size_t candidate = 0; candidate < n; ++candidate) {
+                    const ShardSummary& summary = summaries_[candidate]->summary;
+                    if (tried[i * n + candidate] || !summary.mayFit(cpu, mem)) {
+                        continue;
+                    }
+                    if (best == n || summary.freeCpu > summaries_[best]->summary.freeCpu) {
+                        best = candidate;
+                    }
+                }
+                if (best != n) {
+                    batches[best].push_back(i);
+                    tried[i * n + best] = true;
+                    spilled = true;
+                }
+            }
+        }
+        if (!spilled) {
+            break;
+        }
+    }
+    return scheduled;
+}
+
+KubernetesCluster& ClusterFederation::getShard(size_t shard) {
+    if (shard >= shards_.size()) {
+        throw CloudException("Federation: shard invalide");
+    }
+    return *shards_[shard];
+}
+
+const ShardSummary& ClusterFederation::getSummary(size_t shard) const {
+    if (shard >= summaries_.size()) {
+        throw CloudException("Federation: shard invalide");
+    }
+    return summaries_[shard]->summary;
+}
+
+bool ClusterFederation::contains(const string& podName) const {
+    for (const auto& shard: shards_) {
+        if (shard->getPods().contains(podName)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ClusterFederation::size() const noexcept {
+    return shards_.size();
+}
@@ -0,0 +1,67 @@
+#ifndef CLUSTERFEDERATION_HPP
+#define CLUSTERFEDERATION_HPP
+
+#include "KubernetesCluster.hpp"
+
+enum class ShardRouting {
+    Hash,   // hash of the pod name
+    Zone    // "zone" label of the pod, hash when missing or unknown
+};
+
+// Cheap view of a shard used for routing, kept up to date by the shard's events
+struct ShardSummary {
+    double freeCpu = 0.0;
+    double freeMem = 0.0;
+    size_t nodes = 0;
+    size_t pods = 0;
+
+    bool mayFit(double cpu, double mem) const noexcept;
+};
+
+/*
+    Federation of several KubernetesCluster shards.
+
+    deployPods() works in rounds :
+        round 0 : every pod goes to its first-choice shard
+        round n : pods refused by a shard spill over to the untried shard with the most free cpu
+    Inside a round, every shard schedules its own batch on its own thread ;
+    shards share nothing, so no lock is needed.
+*/
+class ClusterFederation {
+    private:
+        class SummaryListener : public ClusterListener {
+            public:
+                ShardSummary summary;
+                void onServerAdded(const Server& server) override;
+                void onServerRemoved(const Server& server) override;
+                void onPodScheduled(const Pod& pod, const Server& server) override;
+                void onPodEvicted(const Pod& pod, const Server& server) override;
+        };
+
+        ShardRouting routing_;
+        vector<unique_ptr<KubernetesCluster>> shards_;
+        vector<unique_ptr<SummaryListener>> summaries_;
+        unordered_map<string, size_t> zones_;
+
+        size_t hashShard(const string& name) const;
+
+    public:
+        ClusterFederation(ShardRouting routing);
+        ~ClusterFederation();
+
+        size_t addShard(const string& zone);
+        void addServer(size_t shard, const shared_ptr<Server>& server);
+
+        size_t route(const Pod& pod) const;  // first-choice shard
+        // Returns the number of pods scheduled ; the others stay in the vector.
+        // Pod names are unique in the whole federation : duplicates are left out before scheduling.
+        // An error other than AllocationException in a shard is rethrown once every shard is done
+        size_t deployPods(vector<unique_ptr<Pod>>& pods);
+        bool contains(const string& podName) const;  // placed in one of the shards
+
+        KubernetesCluster& getShard(size_t shard);
+        const ShardSummary& getSummary(size_t shard) const;
+        size_t size() const noexcept;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef CLUSTERLISTENER_HPP
+#define CLUSTERLISTENER_HPP
+
+#include "Pod.hpp"
+#include "Server.hpp"
+
+// Observer of a KubernetesCluster : every capacity change is reported here,
+// so modules like the autoscaler can keep incremental state instead of rescanning.
+class ClusterListener {
+    public:
+        virtual ~ClusterListener() = default;
+
+        virtual void onServerAdded(const Server&) {}
+        virtual void onServerRemoved(const Server&) {}
+        virtual void onPodScheduled(const Pod&, const Server&) {}
+        virtual void onPodEvicted(const Pod&, const Server&) {}
+
+        // Called once every listener has heard about the event above. The callbacks above
+        // must not change the cluster ; this one may (the queue retries its pods here)
+        virtual void afterEvent() {}
+};
+
+#endif
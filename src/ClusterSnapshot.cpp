@@ -0,0 +1,286 @@
+#include "ClusterSnapshot.hpp"
+#include "Exceptions.hpp"
+#include <exception>
+#include <limits>
+#include <thread>
+
+double SnapshotSummary::cpuUtilization() const noexcept {
+    return capacityCpu > 0.0 ? allocatedCpu / capacityCpu : 0.0;
+}
+
+double SnapshotSummary::memUtilization() const noexcept {
+    return capacityMem > 0.0 ? allocatedMem / capacityMem : 0.0;
+}
+
+static const size_t NODE_BITS = 5;
+static const size_t FANOUT = size_t(1) << NODE_BITS;   // 32 nodes per leaf, 32 children per branch
+static const size_t SLOT_MASK = FANOUT - 1;
+static const size_t LEAF_ENTRIES = 8;                 // ids per index leaf before it splits
+
+struct ClusterSnapshot::TableNode {
+    vector<NodeCapacity> nodes;                   // leaf
+    vector<shared_ptr<TableNode>> children;       // branch
+};
+
+struct ClusterSnapshot::IndexNode {
+    vector<pair<string, size_t>> entries;         // leaf
+    vector<shared_ptr<IndexNode>> children;       // branch : FANOUT entries, nullptr if empty
+};
+
+// Makes p writable : a node still shared with another snapshot is cloned first
+template <typename T>
+static T& own(shared_ptr<T>& p) {
+    if (p.use_count() > 1) {
+        p = make_shared<T>(*p);
+    }
+    return *p;
+}
+
+ClusterSnapshot::ClusterSnapshot()
+    : table_(make_shared<TableNode>()),
+        tableShift_(0),
+        index_(make_shared<IndexNode>()),
+        size_(0),
+        activeNodes_(0),
+        capacityCpu_(0.0),
+        capacityMem_(0.0),
+        allocatedCpu_(0.0),
+        allocatedMem_(0.0),
+        placedPods_(0),
+        unplacedPods_(0) {}
+
+ClusterSnapshot ClusterSnapshot::fromCluster(const KubernetesCluster& cluster) {
+    ClusterSnapshot snapshot;
+    for (const auto& server: cluster.getNodes()) {
+        snapshot.addNode(server->getId(), server->getInitialCpu(), server->getInitialMem());
+        NodeCapacity& node = snapshot.mutableNode(snapshot.size_ - 1);
+        node.available_cpu = server->getAvailableCpu();
+        node.available_mem = server->getAvailableMem();
+        snapshot.allocatedCpu_ += node.initial_cpu - node.available_cpu;
+        snapshot.allocatedMem_ += node.initial_mem - node.available_mem;
+    }
+
+    // Remember which pod sits where, drainNode() needs it to move them
+    for (const auto& pod: cluster.getPods()) {
+        const size_t* position = snapshot.findNode(pod->getNode());
+        if (position == nullptr) {
+            continue;
+        }
+        snapshot.mutableNode(*position).pods.emplace_back(pod->getCpuRequest(), pod->getMemRequest());
+        ++snapshot.placedPods_;
+    }
+    return snapshot;
+}
+
+ClusterSnapshot ClusterSnapshot::fork() const {
+    // Copy of the root pointers only : the trees are shared until someone writes
+    return *this;
+}
+
+NodeCapacity& ClusterSnapshot::mutableNode(size_t index) {
+    TableNode* node = &own(table_);
+    for (size_t shift = tableShift_; shift > 0; shift -= NODE_BITS) {
+        node = &own(node->children[(index >> shift) & SLOT_MASK]);
+    }
+    return node->nodes[index & SLOT_MASK];
+}
+
+const size_t* ClusterSnapshot::findNode(const string& id) const {
+    const size_t hash = std::hash<string>()(id);
+    const IndexNode* node = index_.get();
+    for (size_t shift = 0; !node->children.empty(); shift += NODE_BITS) {
+        node = node->children[(hash >> shift) & SLOT_MASK].get();
+        if (node == nullptr) {
+            return nullptr;
+        }
+    }
+    for (const auto& entry: node->entries) {
+        if (entry.first == id) {
+            return &entry.second;
+        }
+    }
+    return nullptr;
+}
+
+void ClusterSnapshot::indexNode(const string& id, size_t position) {
+    const size_t hash = std::hash<string>()(id);
+    IndexNode* node = &own(index_);
+    size_t shift = 0;
+    for (; !node->children.empty(); shift += NODE_BITS) {
+        auto& child = node->children[(hash >> shift) & SLOT_MASK];
+        if (child == nullptr) {
+            child = make_shared<IndexNode>();
+        }
+        node = &own(child);
+    }
+    node->entries.emplace_back(id, position);
+
+    // Leaf trop pleine : ses ids descendent d'un niveau, tant qu'il reste des bits de hash
+    if (node->entries.size() > LEAF_ENTRIES && shift + NODE_BITS < numeric_limits<size_t>::digits) {
+        node->children.resize(FANOUT);
+        for (auto& entry: node->entries) {
+            auto& child = node->children[(std::hash<string>()(entry.first) >> shift) & SLOT_MASK];
+            if (child == nullptr) {
+                child = make_shared<IndexNode>();
+            }
+            child->entries.push_back(move(entry));
+        }
+        node->entries.clear();
+    }
+}
+
+void ClusterSnapshot::addNode(const string& id, double cpu, double mem) {
+    if (findNode(id) != nullptr) {
+        throw CloudException("Snapshot: le noeud " + id + " existe deja");
+    }
+
+    // Full tree : it becomes the first child of a new root
+    if (size_ == (FANOUT << tableShift_)) {
+        auto root = make_shared<TableNode>();
+        root->children.push_back(move(table_));
+        table_ = move(root);
+        tableShift_ += NODE_BITS;
+    }
+    TableNode* node = &own(table_);
+    for (size_t shift = tableShift_; shift > 0; shift -= NODE_BITS) {
+        const size_t slot = (size_ >> shift) & SLOT_MASK;
+        if (slot == node->children.size()) {
+            node->children.push_back(make_shared<TableNode>());
+        }
+        node = &own(node->children[slot]);
+    }
+    node->nodes.push_back(NodeCapacity{id, cpu, mem, cpu, mem, false, {}});
+    indexNode(id, size_);
+
+    ++size_;
+    ++activeNodes_;
+    capacityCpu_ += cpu;
+    capacityMem_ += mem;
+}
+
+bool ClusterSnapshot::place(double cpu, double mem) {
+    // First fit, like KubernetesCluster::schedulePod ; reading never clones
+    for (size_t i = 0; i < size_; ++i) {
+        const NodeCapacity& candidate = getNode(i);
+        if (candidate.drained || cpu > candidate.available_cpu || mem > candidate.available_mem) {
+            continue;
+        }
+        NodeCapacity& node = mutableNode(i);
+        node.available_cpu -= cpu;
+        node.available_mem -= mem;
+        node.pods.emplace_back(cpu, mem);
+        allocatedCpu_ += cpu;
+        allocatedMem_ += mem;
+        ++placedPods_;
+        return true;
+    }
+    return false;
+}
+
+void ClusterSnapshot::schedulePod(const Pod& pod) {
+    if (!place(pod.getCpuRequest(), pod.getMemRequest())) {
+        ++unplacedPods_;
+        throw AllocationException("Snapshot: aucun noeud disponible pour ce pod");
+    }
+}
+
+size_t ClusterSnapshot::schedulePods(const vector<unique_ptr<Pod>>& pods) {
+    size_t placed = 0;
+    for (const auto& pod: pods) {
+        if (place(pod->getCpuRequest(), pod->getMemRequest())) {
+            ++placed;
+        } else {
+            ++unplacedPods_;
+        }
+    }
+    return placed;
+}
+
+void ClusterSnapshot::drainNode(const string& id) {
+    const size_t* position = findNode(id);
+    if (position == nullptr) {
+        throw CloudException("Snapshot: noeud inconnu " + id);
+    }
+    if (getNode(*position).drained) {
+        return;
+    }
+
+    vector<pair<double, double>> evicted;
+    {
+        NodeCapacity& node = mutableNode(*position);
+        node.drained = true;
+        evicted.swap(node.pods);
+        allocatedCpu_ -= node.initial_cpu - node.available_cpu;
+        allocatedMem_ -= node.initial_mem - node.available_mem;
+        capacityCpu_ -= node.initial_cpu;
+        capacityMem_ -= node.initial_mem;
+        node.available_cpu = node.initial_cpu;
+        node.available_mem = node.initial_mem;
+    }
+    --activeNodes_;
+    placedPods_ -= evicted.size();
+
+    // Reschedule what was running on the drained node
+    for (const auto& demand: evicted) {
+        if (!place(demand.first, demand.second)) {
+            ++unplacedPods_;
+        }
+    }
+}
+
+const NodeCapacity& ClusterSnapshot::getNode(size_t index) const {
+    if (index >= size_) {
+        throw CloudException("Snapshot: index de noeud invalide");
+    }
+    const TableNode* node = table_.get();
+    for (size_t shift = tableShift_; shift > 0; shift -= NODE_BITS) {
+        node = node->children[(index >> shift) & SLOT_MASK].get();
+    }
+    return node->nodes[index & SLOT_MASK];
+}
+
+const NodeCapacity& ClusterSnapshot::getNode(const string& id) const {
+    const size_t* position = findNode(id);
+    if (position == nullptr) {
+        throw CloudException("Snapshot: noeud inconnu " + id);
+    }
+    return getNode(*position);
+}
+
+size_t ClusterSnapshot::size() const noexcept {
+    return size_;
+}
+
+SnapshotSummary ClusterSnapshot::summary() const noexcept {
+    return {size_, activeNodes_, capacityCpu_, capacityMem_,
+            allocatedCpu_, allocatedMem_, placedPods_, unplacedPods_};
+}
+
+vector<SnapshotSummary> runWhatIf(const ClusterSnapshot& base,
+                                  const vector<function<void(ClusterSnapshot&)>>& scenarios) {
+    vector<SnapshotSummary> results(scenarios.size());
+    vector<exception_ptr> errors(scenarios.size());
+    vector<thread> workers;
+    workers.reserve(scenarios.size());
+
+    for (size_t i = 0; i < scenarios.size(); ++i) {
+        workers.emplace_back([&, i]() {
+            try {
+                ClusterSnapshot scenario = base.fork();
+                scenarios[i](scenario);
+                results[i] = scenario.summary();
+            } catch (...) {
+                errors[i] = current_exception();
+            }
+        });
+    }
+    for (auto& worker: workers) {
+        worker.join();
+    }
+    for (const auto& error: errors) {
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+    return results;
+}
@@ -0,0 +1,91 @@
+#ifndef CLUSTERSNAPSHOT_HPP
+#define CLUSTERSNAPSHOT_HPP
+
+#include "KubernetesCluster.hpp"
+#include <functional>
+
+// Capacity of one node inside a snapshot (no Server object, just numbers)
+struct NodeCapacity {
+    string id;
+    double initial_cpu;
+    double initial_mem;
+    double available_cpu;
+    double available_mem;
+    bool drained;
+    vector<pair<double, double>> pods;  // (cpu, mem) of every pod placed on the node
+};
+
+// Result of a what-if scenario, cheap to compare between forks
+struct SnapshotSummary {
+    size_t nodes;
+    size_t activeNodes;
+    double capacityCpu;
+    double capacityMem;
+    double allocatedCpu;
+    double allocatedMem;
+    size_t placedPods;
+    size_t unplacedPods;
+
+    double cpuUtilization() const noexcept;
+    double memUtilization() const noexcept;
+};
+
+/*
+    Copy-on-write capacity table of a cluster.
+
+    Two persistent trees with 32-way nodes, shared between forks :
+        table_   chunk tree, leaves hold 32 consecutive nodes
+        index_   hash trie, node id -> position in table_
+    fork() copies the two root pointers, O(1). A write clones only the path from
+    the root to the touched leaf, if it is still shared : O(log32 N) per changed
+    node, so a scenario pays O(changed nodes) and the baseline is never modified.
+
+    A forked snapshot belongs to one thread, but several threads can fork the
+    same baseline at the same time as long as nobody writes to the baseline.
+*/
+class ClusterSnapshot {
+    private:
+        struct TableNode;
+        struct IndexNode;
+
+        shared_ptr<TableNode> table_;
+        size_t tableShift_;                // index bits above the leaves
+        shared_ptr<IndexNode> index_;
+        size_t size_;
+
+        // Running totals, so summary() never rescans the table
+        size_t activeNodes_;
+        double capacityCpu_;
+        double capacityMem_;
+        double allocatedCpu_;
+        double allocatedMem_;
+        size_t placedPods_;
+        size_t unplacedPods_;
+
+        NodeCapacity& mutableNode(size_t index);
+        const size_t* findNode(const string& id) const;   // nullptr if unknown
+        void indexNode(const string& id, size_t position);
+        bool place(double cpu, double mem);
+
+    public:
+        ClusterSnapshot();
+        static ClusterSnapshot fromCluster(const KubernetesCluster& cluster);
+
+        ClusterSnapshot fork() const;
+
+        void addNode(const string& id, double cpu, double mem);
+        void drainNode(const string& id);
+        void schedulePod(const Pod& pod);
+        size_t schedulePods(const vector<unique_ptr<Pod>>& pods);
+
+        const NodeCapacity& getNode(size_t index) const;
+        const NodeCapacity& getNode(const string& id) const;
+        size_t size() const noexcept;
+        SnapshotSummary summary() const noexcept;
+};
+
+// Runs every scenario on its own fork of base, one thread per scenario
+vector<SnapshotSummary> runWhatIf(const ClusterSnapshot& base,
+                                  const vector<function<void(ClusterSnapshot&)>>& scenarios);
+
+#endif
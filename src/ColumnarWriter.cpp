@@ -0,0 +1,195 @@
+#include "ColumnarWriter.hpp"
+#include "Exceptions.hpp"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "ColumnarWriter writes the host representation, which must be little-endian"
+#endif
+
+static const char MAGIC[8] = {'C', 'S', 'I', 'M', 'C', 'O', 'L', '1'};
+static const uint32_t VERSION = 1;
+
+ColumnarWriter::ColumnarWriter(const string& filename, vector<ColumnSpec> schema, size_t batchRows)
+    : file_(filename, ios::binary | ios::trunc),
+        filename_(filename),
+        batchRows_(batchRows == 0 ? 1 : batchRows),
+        cursor_(0),
+        rows_(0),
+        totalRows_(0),
+        batches_(0),
+        bytes_(0),
+        closed_(false)
+{
+    if (!file_.is_open()) {
+        throw FileException("Cannot open this file :" + filename);
+    }
+    if (schema.empty()) {
+        throw CloudException("ColumnarWriter: empty schema for " + filename);
+    }
+
+    write(MAGIC, sizeof(MAGIC));
+    const uint32_t count = static_cast<uint32_t>(schema.size());
+    write(&VERSION, sizeof(VERSION));
+    write(&count, sizeof(count));
+    for (auto& spec: schema) {
+        const uint8_t type[2] = {static_cast<uint8_t>(spec.type), 0};
+        const uint16_t length = static_cast<uint16_t>(spec.name.size());
+        write(type, sizeof(type));
+        write(&length, sizeof(length));
+        write(spec.name.data(), length);
+
+        Column column;
+        column.spec = move(spec);
+        columns_.push_back(move(column));
+    }
+    pad();
+
+    for (auto& column: columns_) {
+        switch (column.spec.type) {
+            case ColumnType::Float64: column.floats.reserve(batchRows_); break;
+            case ColumnType::Int64:   column.ints.reserve(batchRows_); break;
+            case ColumnType::String:  column.codes.reserve(batchRows_); break;
+        }
+    }
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    try {
+        close();
+    } catch (const CloudException&) {
+        // Pas d'exception dans un destructeur : appeler close() pour voir l'erreur
+    }
+}
+
+void ColumnarWriter::write(const void* data, size_t size) {
+    file_.write(static_cast<const char*>(data), static_cast<streamsize>(size));
+    if (!file_) {
+        throw FileException("Cannot write this file :" + filename_);
+    }
+    bytes_ += size;
+}
+
+void ColumnarWriter::pad() {
+    static const char zeros[8] = {0};
+    if (bytes_ % 8 != 0) {
+        write(zeros, 8 - bytes_ % 8);
+    }
+}
+
+ColumnarWriter::Column& ColumnarWriter::next(ColumnType type) {
+    if (closed_) {
+        throw CloudException("ColumnarWriter: " + filename_ + " is closed");
+    }
+    if (cursor_ >= columns_.size()) {
+        throw CloudException("ColumnarWriter: too many values in a row of " + filename_);
+    }
+    Column& column = columns_[cursor_];
+    if (column.spec.type != type) {
+        throw CloudException("ColumnarWriter: wrong type for column " + column.spec.name);
+    }
+    ++cursor_;
+    return column;
+}
+
+ColumnarWriter& ColumnarWriter::addFloat(double value) {
+    next(ColumnType::Float64).floats.push_back(value);
+    return *this;
+}
+
+ColumnarWriter& ColumnarWriter::addInt(int64_t value) {
+    next(ColumnType::Int64).ints.push_back(value);
+    return *this;
+}
+
+ColumnarWriter& ColumnarWriter::addString(const string& value) {
+    Column& column = next(ColumnType::String);
+    if (column.lastCode < 0 || column.last != value) {
+        auto inserted = column.dictionary.try_emplace(value, static_cast<int32_t>(column.dictionary.size()));
+        if (inserted.second) {
+            column.fresh.push_back(value);
+        }
+        column.last = value;
+        column.lastCode = inserted.first->second;
+    }
+    column.codes.push_back(column.lastCode);
+    return *this;
+}
+
+void ColumnarWriter::endRow() {
+    if (cursor_ != columns_.size()) {
+        throw CloudException("ColumnarWriter: incomplete row in " + filename_);
+    }
+    cursor_ = 0;
+    ++totalRows_;
+    if (++rows_ == batchRows_) {
+        flush();
+    }
+}
+
+void ColumnarWriter::flush() {
+    if (rows_ == 0) {
+        return;
+    }
+    const uint64_t rows = rows_;
+    write(&rows, sizeof(rows));
+
+    for (auto& column: columns_) {
+        if (column.spec.type != ColumnType::String) {
+            continue;
+        }
+        const uint32_t count = static_cast<uint32_t>(column.fresh.size());
+        write(&count, sizeof(count));
+        for (const auto& entry: column.fresh) {
+            const uint32_t length = static_cast<uint32_t>(entry.size());
+            write(&length, sizeof(length));
+            write(entry.data(), length);
+        }
+        column.fresh.clear();
+    }
+    pad();
+
+    for (auto& column: columns_) {
+        switch (column.spec.type) {
+            case ColumnType::Float64:
+                write(column.floats.data(), column.floats.size() * sizeof(double));
+                column.floats.clear();
+                break;
+            case ColumnType::Int64:
+                write(column.ints.data(), column.ints.size() * sizeof(int64_t));
+                column.ints.clear();
+                break;
+            case ColumnType::String:
+                write(column.codes.data(), column.codes.size() * sizeof(int32_t));
+                column.codes.clear();
+                break;
+        }
+        pad();
+    }
+    rows_ = 0;
+    ++batches_;
+}
+
+void ColumnarWriter::close() {
+    if (closed_) {
+        return;
+    }
+    if (cursor_ != 0) {
+        throw CloudException("ColumnarWriter: incomplete row in " + filename_);
+    }
+    closed_ = true;
+    flush();
+    const uint64_t footer[2] = {0, totalRows_};
+    write(footer, sizeof(footer));
+    file_.close();
+}
+
+size_t ColumnarWriter::getRows() const noexcept {
+    return totalRows_;
+}
+
+size_t ColumnarWriter::getBatches() const noexcept {
+    return batches_;
+}
+
+uint64_t ColumnarWriter::getBytes() const noexcept {
+    return bytes_;
+}
@@ -0,0 +1,97 @@
+#ifndef COLUMNARWRITER_HPP
+#define COLUMNARWRITER_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+/*
+    Columnar file layout ("CSIMCOL1"), everything little-endian, every block 8-byte aligned
+    so numpy.frombuffer can map the columns without copying them :
+
+        header   char[8]  "CSIMCOL1"
+                 u32      version (1)
+                 u32      number of columns
+                 per column : u8 type, u8 0, u16 name length, name bytes
+                 zero padding to a multiple of 8
+
+        batch    u64      rows (> 0)
+                 per String column, in schema order :
+                     u32 new dictionary entries, then per entry u32 length + bytes
+                 zero padding to a multiple of 8
+                 per column, in schema order :
+                     Float64 : rows x f64
+                     Int64   : rows x i64
+                     String  : rows x i32 dictionary code
+                     zero padding to a multiple of 8
+
+        footer   u64      0 (end of stream)
+                 u64      total rows
+
+    Dictionaries are deltas : a batch only carries the strings first seen in it,
+    codes index the concatenation of all the entries read so far.
+    notebooks/cloudsim_columns.py loads such a file into a pandas DataFrame.
+*/
+enum class ColumnType : uint8_t { Float64 = 0, Int64 = 1, String = 2 };
+
+struct ColumnSpec {
+    string name;
+    ColumnType type;
+};
+
+// Streams rows into a columnar file, one batch every batchRows rows
+class ColumnarWriter {
+    private:
+        struct Column {
+            ColumnSpec spec;
+            vector<double> floats;
+            vector<int64_t> ints;
+            vector<int32_t> codes;
+            unordered_map<string, int32_t> dictionary;
+            vector<string> fresh;   // entries not written yet
+            string last;            // repeated values (a pod name per container) skip the hash
+            int32_t lastCode = -1;
+        };
+
+        ofstream file_;
+        string filename_;
+        vector<Column> columns_;
+        size_t batchRows_;
+        size_t cursor_;      // next column of the row being built
+        size_t rows_;        // rows in the current batch
+        size_t totalRows_;
+        size_t batches_;
+        uint64_t bytes_;
+        bool closed_;
+
+        Column& next(ColumnType type);
+        void flush();
+        void write(const void* data, size_t size);
+        void pad();
+
+    public:
+        static constexpr size_t DEFAULT_BATCH_ROWS = 65536;
+
+        ColumnarWriter(const string& filename, vector<ColumnSpec> schema, size_t batchRows = DEFAULT_BATCH_ROWS);
+        ~ColumnarWriter();
+        ColumnarWriter(const ColumnarWriter&) = delete;
+        ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+        // One value per column, in schema order, then endRow()
+        ColumnarWriter& addFloat(double value);
+        ColumnarWriter& addInt(int64_t value);
+        ColumnarWriter& addString(const string& value);
+        void endRow();
+
+        // Writes the last batch and the footer ; called by the destructor otherwise
+        void close();
+
+        size_t getRows() const noexcept;
+        size_t getBatches() const noexcept;
+        uint64_t getBytes() const noexcept;
+};
+
+#endif
@@ -19,6 +19,10 @@ void Container::stop() {
     active_ = false;
 }
 
+const string& Container::getImage() const noexcept {
+    return image_;
+}
+
 string Container::getMetrics() const {
     std::ostringstream oss;
     oss << "[Container: " << id_ << ": "
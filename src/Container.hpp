@@ -16,7 +16,7 @@ public:
     void stop() override;
 
     // Getter for image : 
-    string& getImage() const;
+    const string& getImage() const noexcept;
 
     string getMetrics() const override;
     friend ostream& operator<<(ostream& os, const Container& c);
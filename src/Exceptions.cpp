@@ -16,5 +16,8 @@ CloudException::~CloudException() {}
 AllocationException::AllocationException(const std::string& message)
     : CloudException(message) {}
 
+DuplicatePodException::DuplicatePodException(const std::string& message)
+    : AllocationException(message) {}
+
 FileException::FileException(const std::string& message) 
     : CloudException(message) {}
\ No newline at end of file
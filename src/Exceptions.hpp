@@ -20,6 +20,13 @@ class AllocationException : public CloudException {
 
 };
 
+// Name already taken by a pod of the cluster : an allocation failure like the others,
+// the pod is left to the caller
+class DuplicatePodException : public AllocationException {
+    public:
+        DuplicatePodException(const std::string& message);
+};
+
 class FileException : public CloudException {
     public:
         FileException(const std::string& message);
@@ -0,0 +1,345 @@
+#include "Instrumentation.hpp"
+#include "Exceptions.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+const char* counterName(Counter c) noexcept {
+    switch (c) {
+        case Counter::ScheduleAttempts: return "schedule_attempts";
+        case Counter::NodesScanned:     return "nodes_scanned";
+        case Counter::ScheduleFailures: return "schedule_failures";
+        case Counter::GangRollbacks:    return "gang_rollbacks";
+        default:                        return "unknown";
+    }
+}
+
+const char* timerName(Timer t) noexcept {
+    switch (t) {
+        case Timer::Schedule:      return "schedule";
+        case Timer::Parse:         return "parse";
+        case Timer::MetricsExport: return "metrics_export";
+        default:                   return "unknown";
+    }
+}
+
+/*
+    Bucket layout (S = 5 bits of precision) :
+        ns < 32          -> bucket = ns
+        ns >= 32         -> m = msb(ns) - 4, sub = ns >> m in [16, 32), bucket = 16 * m + sub
+*/
+size_t LatencyHistogram::bucketOf(uint64_t ns) noexcept {
+    if (ns < 32) {
+        return static_cast<size_t>(ns);
+    }
+    const int msb = 63 - __builtin_clzll(ns);
+    const int m = msb - 4;
+    return static_cast<size_t>(16 * m) + static_cast<size_t>(ns >> m);
+}
+
+uint64_t LatencyHistogram::upperEdge(size_t bucket) noexcept {
+    if (bucket < 32) {
+        return bucket;
+    }
+    const size_t m = bucket / 16 - 1;
+    const uint64_t sub = bucket - 16 * m;
+    return ((sub + 1) << m) - 1;
+}
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram& other) noexcept {
+    merge(other);
+}
+
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& other) noexcept {
+    if (this != &other) {
+        clear();
+        merge(other);
+    }
+    return *this;
+}
+
+void LatencyHistogram::record(uint64_t ns) noexcept {
+    auto& bucket = buckets_[bucketOf(ns)];
+    bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    count_.store(count_.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    sum_.store(sum_.load(memory_order_relaxed) + ns, memory_order_relaxed);
+    if (ns > max_.load(memory_order_relaxed)) {
+        max_.store(ns, memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept {
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        const uint64_t n = other.buckets_[i].load(memory_order_relaxed);
+        if (n != 0) {
+            buckets_[i].store(buckets_[i].load(memory_order_relaxed) + n, memory_order_relaxed);
+        }
+    }
+    count_.store(count_.load(memory_order_relaxed) + other.count_.load(memory_order_relaxed), memory_order_relaxed);
+    sum_.store(sum_.load(memory_order_relaxed) + other.sum_.load(memory_order_relaxed), memory_order_relaxed);
+    const uint64_t otherMax = other.max_.load(memory_order_relaxed);
+    if (otherMax > max_.load(memory_order_relaxed)) {
+        max_.store(otherMax, memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::clear() noexcept {
+    for (auto& bucket: buckets_) {
+        bucket.store(0, memory_order_relaxed);
+    }
+    count_.store(0, memory_order_relaxed);
+    sum_.store(0, memory_order_relaxed);
+    max_.store(0, memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const noexcept {
+    return count_.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double p) const noexcept {
+    const uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.5);
+    rank = rank == 0 ? 1 : (rank > total ? total : rank);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets_[i].load(memory_order_relaxed);
+        if (seen >= rank) {
+            const uint64_t edge = upperEdge(i);
+            return edge < max() ? edge : max();
+        }
+    }
+    return max();
+}
+
+uint64_t LatencyHistogram::max() const noexcept {
+    return max_.load(memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const noexcept {
+    const uint64_t n = count();
+    return n == 0 ? 0.0 : static_cast<double>(sum_.load(memory_order_relaxed)) / static_cast<double>(n);
+}
+
+uint64_t InstrumentationReport::get(Counter c) const noexcept {
+    return counters[static_cast<size_t>(c)];
+}
+
+const LatencyHistogram& InstrumentationReport::get(Timer t) const noexcept {
+    return timers[static_cast<size_t>(t)];
+}
+
+string InstrumentationReport::toString() const {
+    ostringstream oss;
+    oss << "Instrumentation:\n";
+    oss << "Counters:\n";
+    for (size_t i = 0; i < counters.size(); ++i) {
+        oss << "  " << counterName(static_cast<Counter>(i)) << " = " << counters[i] << "\n";
+    }
+    oss << "Latencies (ns):\n";
+    for (size_t i = 0; i < timers.size(); ++i) {
+        const LatencyHistogram& h = timers[i];
+        oss << "  " << timerName(static_cast<Timer>(i)) << ": count=" << h.count()
+            << " mean=" << fixed << setprecision(1) << h.mean()
+            << " p50=" << h.percentile(50) << " p99=" << h.percentile(99)
+            << " p99.9=" << h.percentile(99.9) << " max=" << h.max() << "\n";
+    }
+    return oss.str();
+}
+
+/*
+    Registry of the per-thread slots. A thread registers on its first event ;
+    when it exits its numbers are folded into retired_ so short-lived threads
+    (federation rounds, what-if scenarios) do not pile up.
+*/
+namespace {
+
+struct Registry {
+    mutex lock;
+    unordered_set<ThreadStats*> live;
+    InstrumentationReport retired;
+
+    // Trace buffer, only touched while the trace is enabled
+    struct Event {
+        Timer timer;
+        uint64_t start;
+        uint64_t duration;
+        size_t tid;
+        string detail;
+    };
+    size_t maxEvents = 0;
+    vector<Event> events;
+};
+
+Registry& registry() {
+    static Registry* r = new Registry();  // never destroyed : threads may exit after main
+    return *r;
+}
+
+void fold(InstrumentationReport& into, const ThreadStats& stats) {
+    for (size_t i = 0; i < into.counters.size(); ++i) {
+        into.counters[i] += stats.counters[i].load(memory_order_relaxed);
+    }
+    for (size_t i = 0; i < into.timers.size(); ++i) {
+        into.timers[i].merge(stats.timers[i]);
+    }
+}
+
+struct ThreadSlot {
+    unique_ptr<ThreadStats> stats;
+
+    ThreadSlot() : stats(make_unique<ThreadStats>()) {
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        r.live.insert(stats.get());
+    }
+    ~ThreadSlot() {
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        fold(r.retired, *stats);
+        r.live.erase(stats.get());
+    }
+};
+
+size_t threadNumber() {
+    static atomic<size_t> next{1};
+    thread_local size_t id = next.fetch_add(1);
+    return id;
+}
+
+string escapeJson(const string& s) {
+    string out;
+    out.reserve(s.size());
+    for (char c: s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    ostringstream hex;
+                    hex << "\\u" << setw(4) << setfill('0') << std::hex << static_cast<int>(c);
+                    out += hex.str();
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+}
+
+bool Instrumentation::compiledIn() noexcept {
+#ifdef CLOUDSIM_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+atomic<uint32_t> Instrumentation::samplePeriod_{64};
+atomic<bool> Instrumentation::tracing_{false};
+
+ThreadStats& Instrumentation::registerThread() {
+    thread_local ThreadSlot slot;
+    return *slot.stats;
+}
+
+void Instrumentation::setSamplePeriod(uint32_t period) noexcept {
+    samplePeriod_.store(period == 0 ? 1 : period, memory_order_relaxed);
+}
+
+InstrumentationReport Instrumentation::collect() {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    InstrumentationReport report = r.retired;
+    for (const ThreadStats* stats: r.live) {
+        fold(report, *stats);
+    }
+    return report;
+}
+
+void Instrumentation::reset() {
+    // Meant for quiescent moments (between benchmark runs) : other threads may still be writing
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    r.retired = InstrumentationReport();
+    for (ThreadStats* stats: r.live) {
+        for (auto& c: stats->counters) {
+            c.store(0, memory_order_relaxed);
+        }
+        for (auto& t: stats->timers) {
+            t.clear();
+        }
+    }
+    r.events.clear();
+}
+
+void Instrumentation::enableTrace(bool enabled, size_t maxEvents) {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    r.maxEvents = maxEvents;
+    tracing_.store(enabled, memory_order_relaxed);
+}
+
+void Instrumentation::traceEvent(Timer timer, uint64_t startNs, uint64_t durationNs, const string& detail) {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    if (r.events.size() < r.maxEvents) {
+        r.events.push_back({timer, startNs, durationNs, threadNumber(), detail});
+    }
+}
+
+size_t Instrumentation::traceSize() {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    return r.events.size();
+}
+
+void Instrumentation::dumpTrace(const string& filename) {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        throw FileException("Cannot open this file :" + filename);
+    }
+
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    // Events are pushed when their scope ends : an outer scope comes after the ones it holds
+    uint64_t origin = r.events.empty() ? 0 : r.events.front().start;
+    for (const auto& e: r.events) {
+        origin = min(origin, e.start);
+    }
+
+    // "X" = complete event, timestamps in microseconds
+    file << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < r.events.size(); ++i) {
+        const auto& e = r.events[i];
+        file << "{\"name\":\"" << timerName(e.timer) << "\",\"cat\":\"cloudsim\",\"ph\":\"X\""
+             << ",\"ts\":" << fixed << setprecision(3) << static_cast<double>(e.start - origin) / 1000.0
+             << ",\"dur\":" << static_cast<double>(e.duration) / 1000.0
+             << ",\"pid\":1,\"tid\":" << e.tid
+             << ",\"args\":{\"detail\":\"" << escapeJson(e.detail) << "\"}}"
+             << (i + 1 < r.events.size() ? ",\n" : "\n");
+    }
+    file << "],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void ScopedTimer::finish() {
+    const uint64_t end = Instrumentation::nowNs();
+    stats_.timers[static_cast<size_t>(timer_)].record(end - start_);
+    if (Instrumentation::traceEnabled()) {
+        Instrumentation::traceEvent(timer_, start_, end - start_, stats_.traceDetail);
+        stats_.traceDetail.clear();
+    }
+}
@@ -0,0 +1,184 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+using namespace std;
+
+/*
+    Hot-path instrumentation of the scheduler.
+
+    Built with -DCLOUDSIM_INSTRUMENTATION (CMake option of the same name) the macros below
+    feed per-thread counters and latency histograms ; without it they expand to nothing.
+    Every thread writes only to its own slot (no lock, no shared cache line),
+    Instrumentation::collect() merges the slots when someone asks for the numbers.
+
+    Reading the clock costs about as much as a whole schedulePod(), so timers are
+    sampled : one scope out of samplePeriod() is timed (all of them while tracing).
+    Counters are always exact.
+
+    The thread's slot is looked up once per scope : CLOUDSIM_TIMED (or CLOUDSIM_STATS
+    in a scope without timer) binds it to a local, that CLOUDSIM_COUNT then uses.
+*/
+
+enum class Counter {
+    ScheduleAttempts,
+    NodesScanned,
+    ScheduleFailures,
+    GangRollbacks,
+    Count
+};
+
+enum class Timer {
+    Schedule,
+    Parse,
+    MetricsExport,
+    Count
+};
+
+const char* counterName(Counter c) noexcept;
+const char* timerName(Timer t) noexcept;
+
+// HDR-style histogram of nanoseconds : 32 exact buckets, then 16 buckets per power of two (~6% precision)
+class LatencyHistogram {
+    public:
+        static constexpr size_t BUCKETS = 976;
+
+        LatencyHistogram() = default;
+        LatencyHistogram(const LatencyHistogram& other) noexcept;
+        LatencyHistogram& operator=(const LatencyHistogram& other) noexcept;
+
+        void record(uint64_t ns) noexcept;
+        void merge(const LatencyHistogram& other) noexcept;
+        void clear() noexcept;
+
+        uint64_t count() const noexcept;
+        uint64_t percentile(double p) const noexcept;  // p in [0, 100], upper edge of the bucket
+        uint64_t max() const noexcept;
+        double mean() const noexcept;
+
+        static size_t bucketOf(uint64_t ns) noexcept;
+        static uint64_t upperEdge(size_t bucket) noexcept;
+
+    private:
+        // Written by one thread only, read by collect() : relaxed atomics, no RMW needed
+        array<atomic<uint64_t>, BUCKETS> buckets_{};
+        atomic<uint64_t> count_{0};
+        atomic<uint64_t> sum_{0};
+        atomic<uint64_t> max_{0};
+};
+
+// Counters and histograms of one thread
+struct ThreadStats {
+    array<atomic<uint64_t>, static_cast<size_t>(Counter::Count)> counters{};
+    array<LatencyHistogram, static_cast<size_t>(Timer::Count)> timers;
+    uint32_t countdown = 1;  // scopes left before the next timed one
+    string traceDetail;      // detail of the traced scope, a buffer reused by the thread
+
+    void add(Counter c, uint64_t n) noexcept {
+        auto& slot = counters[static_cast<size_t>(c)];
+        slot.store(slot.load(memory_order_relaxed) + n, memory_order_relaxed);
+    }
+};
+
+// Plain copy of every thread merged together
+struct InstrumentationReport {
+    array<uint64_t, static_cast<size_t>(Counter::Count)> counters{};
+    array<LatencyHistogram, static_cast<size_t>(Timer::Count)> timers;
+
+    uint64_t get(Counter c) const noexcept;
+    const LatencyHistogram& get(Timer t) const noexcept;
+    string toString() const;
+};
+
+class Instrumentation {
+    public:
+        static bool compiledIn() noexcept;
+
+        static ThreadStats& local() {
+            thread_local ThreadStats* stats = nullptr;
+            if (stats == nullptr) {
+                stats = &registerThread();
+            }
+            return *stats;
+        }
+        static InstrumentationReport collect();
+        static void reset();
+
+        // 1 = time every scope ; the default keeps the overhead of the timers under 2%
+        static void setSamplePeriod(uint32_t period) noexcept;
+        static uint32_t samplePeriod() noexcept {
+            return samplePeriod_.load(memory_order_relaxed);
+        }
+        static bool sampleNow(ThreadStats& stats) noexcept {
+            if (--stats.countdown == 0) {
+                stats.countdown = samplePeriod();
+                return true;
+            }
+            return traceEnabled();
+        }
+
+        // Chrome trace-event export (chrome://tracing, Perfetto) of individual decisions
+        static void enableTrace(bool enabled, size_t maxEvents = 1000000);
+        static bool traceEnabled() noexcept {
+            return tracing_.load(memory_order_relaxed);
+        }
+        static void traceEvent(Timer timer, uint64_t startNs, uint64_t durationNs, const string& detail);
+        static size_t traceSize();
+        static void dumpTrace(const string& filename);
+
+        static uint64_t nowNs() noexcept {
+            return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+    private:
+        static atomic<uint32_t> samplePeriod_;
+        static atomic<bool> tracing_;
+        static ThreadStats& registerThread();
+};
+
+// Records the lifetime of a sampled scope in the thread's histogram (and in the trace when enabled)
+class ScopedTimer {
+    private:
+        ThreadStats& stats_;
+        Timer timer_;
+        uint64_t start_;  // 0 when this scope is not sampled
+        void finish();
+    public:
+        ScopedTimer(ThreadStats& stats, Timer timer) noexcept
+            : stats_(stats), timer_(timer),
+                start_(Instrumentation::sampleNow(stats) ? Instrumentation::nowNs() : 0) {}
+        ~ScopedTimer() {
+            if (start_ != 0) {
+                finish();
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        bool sampled() const noexcept { return start_ != 0; }
+        void setDetail(const string& detail) { stats_.traceDetail = detail; }
+};
+
+#ifdef CLOUDSIM_INSTRUMENTATION
+    #define CLOUDSIM_STATS() ThreadStats& cloudsim_stats = Instrumentation::local()
+    #define CLOUDSIM_TIMED(timer) CLOUDSIM_STATS(); ScopedTimer cloudsim_scoped_timer(cloudsim_stats, Timer::timer)
+    // Needs CLOUDSIM_TIMED or CLOUDSIM_STATS earlier in the scope
+    #define CLOUDSIM_COUNT(counter, n) cloudsim_stats.add(Counter::counter, (n))
+    // Only evaluated when the trace is recording
+    #define CLOUDSIM_TRACE_DETAIL(expr) \
+        do { if (cloudsim_scoped_timer.sampled() && Instrumentation::traceEnabled()) { \
+            cloudsim_scoped_timer.setDetail(expr); } } while (0)
+#else
+    #define CLOUDSIM_STATS() ((void)0)
+    #define CLOUDSIM_COUNT(counter, n) ((void)0)
+    #define CLOUDSIM_TIMED(timer) ((void)0)
+    #define CLOUDSIM_TRACE_DETAIL(expr) ((void)0)
+#endif
+
+#endif
@@ -1,54 +1,198 @@
 #include "KubernetesCluster.hpp"
 #include "Exceptions.hpp"
+#include "Instrumentation.hpp"
+#include <algorithm>
+#include <unordered_set>
 
 KubernetesCluster::KubernetesCluster(string name)
     : name_(name) {}
 KubernetesCluster::~KubernetesCluster() = default;
 
 void KubernetesCluster::schedulePod(unique_ptr<Pod>& pod) {
-    for (auto& node: nodes_) {
-        try {
-            // Try to allocate all containers to this node
-            for (auto& c: pod->getContainers()) {
-                node->allocate(c->getCpu(), c->getMem());  
-            }
+    CLOUDSIM_TIMED(Schedule);
+    CLOUDSIM_COUNT(ScheduleAttempts, 1);
+    const double cpu = pod->getCpuRequest();
+    const double mem = pod->getMemRequest();
 
-            // If we get here, all containers were allocated successfully
-            pod->startAll();
-            pods_.push_back(move(pod));
-            return;
-        } catch (const AllocationException&) {
-            // Reset the node's resources to initial state
-            node->reset();
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        auto& node = nodes_[i];
+        // Check the whole pod first, so a failed attempt never touches the node
+        if (!node->canAllocate(cpu, mem)) {
             continue;
         }
+        CLOUDSIM_COUNT(NodesScanned, i + 1);
+        CLOUDSIM_TRACE_DETAIL(pod->getName() + " -> " + node->getId());
+        // Registered first : a duplicate name throws before the node is touched
+        Pod* placed = pod.get();
+        pods_.insert(pod);
+        node->allocate(cpu, mem);
+        node->addPod();
+        placed->setNode(node->getId());
+        placed->startAll();
+        for (auto* listener: listeners_) {
+            listener->onPodScheduled(*placed, *node);
+        }
+        notifyAfterEvent();
+        return;
     }
+    CLOUDSIM_COUNT(NodesScanned, nodes_.size());
+    CLOUDSIM_COUNT(ScheduleFailures, 1);
+    CLOUDSIM_TRACE_DETAIL(pod->getName() + " -> unschedulable");
     throw AllocationException("Aucun serveur disponible pour ce pod");
 };
 
 /*
-                               |---> Containers allocation is done ! ---> return;
-|---> node->allocate()-------->|
-|                              |---> Exception : Serveur can't allocate these Containers ---> catch():continue -----|
-|                                                                                                                   |
-------------------------------------------------------repeat--------------------------------------------------------|
+                                   |---> Containers allocation is done ! ---> return;
+|---> node->canAllocate(pod)------>|
+|                                  |---> false : Serveur can't hold these Containers ---> continue ---|
+|                                                                                                    |
+----------------------------------------------repeat-------------------------------------------------|
 
 */
 
+void KubernetesCluster::scheduleGang(vector<unique_ptr<Pod>>& group) {
+    CLOUDSIM_STATS();
+    struct Reservation {
+        Server* node;
+        double cpu;
+        double mem;
+    };
+
+    // Tentative phase : reserve capacity member by member, remembering what was taken
+    vector<Reservation> reserved;
+    reserved.reserve(group.size());
+    unordered_set<string> names;
+
+    // Rollback only our own reservations, other pods keep their allocations
+    auto rollback = [&]() {
+        for (auto it = reserved.rbegin(); it != reserved.rend(); ++it) {
+            it->node->release(it->cpu, it->mem);
+        }
+    };
+
+    for (const auto& pod: group) {
+        CLOUDSIM_COUNT(ScheduleAttempts, 1);
+        if (pods_.contains(pod->getName()) || !names.insert(pod->getName()).second) {
+            CLOUDSIM_COUNT(GangRollbacks, 1);
+            rollback();
+            throw DuplicatePodException("Gang : pod deja present : " + pod->getName());
+        }
+        const double cpu = pod->getCpuRequest();
+        const double mem = pod->getMemRequest();
+
+        Server* target = nullptr;
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            if (nodes_[i]->canAllocate(cpu, mem)) {
+                CLOUDSIM_COUNT(NodesScanned, i + 1);
+                target = nodes_[i].get();
+                break;
+            }
+        }
+
+        if (target == nullptr) {
+            CLOUDSIM_COUNT(NodesScanned, nodes_.size());
+            CLOUDSIM_COUNT(GangRollbacks, 1);
+            rollback();
+            throw AllocationException("Gang " + pod->getName() + " : le groupe ne tient pas dans le cluster");
+        }
+
+        target->allocate(cpu, mem);
+        reserved.push_back({target, cpu, mem});
+    }
+
+    // Commit phase : the whole group fits, take ownership of every member
+    for (size_t i = 0; i < group.size(); ++i) {
+        Pod* pod = group[i].get();
+        pods_.insert(group[i]);
+        reserved[i].node->addPod();
+        pod->setNode(reserved[i].node->getId());
+        pod->startAll();
+        for (auto* listener: listeners_) {
+            listener->onPodScheduled(*pod, *reserved[i].node);
+        }
+    }
+    notifyAfterEvent();
+};
+
 void KubernetesCluster::deployPods(vector<unique_ptr<Pod>>& pods) {
     for (auto& p: pods) {
-        schedulePod(p);
+        try {
+            schedulePod(p);
+        } catch (const AllocationException&) {
+            // The pod stays in the vector, the caller still owns it
+            continue;
+        }
     }    
 };
 
+unique_ptr<Pod> KubernetesCluster::evictPod(const string& name) {
+    unique_ptr<Pod> pod = pods_.remove(name);
+    if (pod == nullptr) {
+        throw CloudException("Pod inconnu : " + name);
+    }
+
+    auto nodeIt = find_if(nodes_.begin(), nodes_.end(),
+                          [&](const shared_ptr<Server>& n) { return n->getId() == pod->getNode(); });
+    pod->stopAll();
+    if (nodeIt != nodes_.end()) {
+        (*nodeIt)->release(pod->getCpuRequest(), pod->getMemRequest());
+        (*nodeIt)->removePod();
+        for (auto* listener: listeners_) {
+            listener->onPodEvicted(*pod, **nodeIt);
+        }
+    }
+    pod->setNode("");
+    notifyAfterEvent();
+    return pod;
+}
+
 void KubernetesCluster::addServer(const shared_ptr<Server>& server) {
     nodes_.push_back(server);
+    for (auto* listener: listeners_) {
+        listener->onServerAdded(*server);
+    }
+    notifyAfterEvent();
+}
+
+void KubernetesCluster::removeServer(const string& id) {
+    auto nodeIt = find_if(nodes_.begin(), nodes_.end(),
+                          [&](const shared_ptr<Server>& n) { return n->getId() == id; });
+    if (nodeIt == nodes_.end()) {
+        throw CloudException("Serveur inconnu : " + id);
+    }
+    if ((*nodeIt)->getPodCount() != 0) {
+        throw CloudException("Le serveur " + id + " heberge encore des pods");
+    }
+
+    shared_ptr<Server> server = *nodeIt;
+    nodes_.erase(nodeIt);
+    for (auto* listener: listeners_) {
+        listener->onServerRemoved(*server);
+    }
+    notifyAfterEvent();
+}
+
+void KubernetesCluster::notifyAfterEvent() {
+    for (auto* listener: listeners_) {
+        listener->afterEvent();
+    }
+}
+
+void KubernetesCluster::addListener(ClusterListener* listener) {
+    listeners_.push_back(listener);
+}
+
+void KubernetesCluster::removeListener(ClusterListener* listener) {
+    listeners_.erase(remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
 }
 
 vector<shared_ptr<Server>>& KubernetesCluster::getNodes() noexcept {
     return nodes_;
 };
-vector<unique_ptr<Pod>>& KubernetesCluster::getPods() noexcept {
+const vector<shared_ptr<Server>>& KubernetesCluster::getNodes() const noexcept {
+    return nodes_;
+};
+const PodRegistry& KubernetesCluster::getPods() const noexcept {
     return pods_;
 };
 string KubernetesCluster::getName() const noexcept {
@@ -56,6 +200,7 @@ string KubernetesCluster::getName() const noexcept {
 };
 
 string KubernetesCluster::getMetrics() const {
+    CLOUDSIM_TIMED(MetricsExport);
     std::ostringstream oss;
     oss << "Cluster Metrics:\n";
     oss << "Servers:\n";
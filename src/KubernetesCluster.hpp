@@ -2,7 +2,9 @@
 #define KUBERNETESCLUSTER_HPP
 
 #include "Pod.hpp"
+#include "PodRegistry.hpp"
 #include "Server.hpp"
+#include "ClusterListener.hpp"
 #include <list>
 using namespace std; 
 
@@ -10,7 +12,10 @@ class KubernetesCluster {
     private:
         string name_;
         vector<shared_ptr<Server>> nodes_;
-        vector<unique_ptr<Pod>> pods_;
+        PodRegistry pods_;  // pods places, indexes par nom
+        vector<ClusterListener*> listeners_;  // non proprietaire
+
+        void notifyAfterEvent();
     public:
 
         KubernetesCluster(string name);
@@ -18,13 +23,25 @@ class KubernetesCluster {
 
         void deployPods(vector<unique_ptr<Pod>>& pods);
         void addServer(const shared_ptr<Server>& server);
+        void removeServer(const string& id);  // only an empty server can be removed
+        // Pod names are unique in a cluster : a duplicate throws DuplicatePodException,
+        // an AllocationException, so the callers that survive a full cluster survive it too
         void schedulePod(unique_ptr<Pod>& pod);
+        // All-or-nothing : either every pod of the group is placed, or none is
+        void scheduleGang(vector<unique_ptr<Pod>>& group);
+        // Stops the pod, gives its capacity back and returns it to the caller
+        unique_ptr<Pod> evictPod(const string& name);
+
+        void addListener(ClusterListener* listener);
+        void removeListener(ClusterListener* listener);
 
         string getMetrics() const;
         friend ostream& operator<<(ostream& os, const KubernetesCluster& k);
 
         vector<shared_ptr<Server>>& getNodes() noexcept;
-        vector<unique_ptr<Pod>>& getPods() noexcept;
+        const vector<shared_ptr<Server>>& getNodes() const noexcept;
+        // Read only : pods come in and out through schedulePod / evictPod
+        const PodRegistry& getPods() const noexcept;
         string getName() const noexcept;
 
 };
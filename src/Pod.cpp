@@ -1,7 +1,8 @@
 #include "Pod.hpp"
+#include "Exceptions.hpp"
 
 Pod::Pod(string name)
-    : name_(name) {};
+    : name_(name), registered_(false) {};
 
 Pod::~Pod() = default;
 
@@ -14,9 +15,17 @@ void Pod::setLabel(const string& key, const string& value) {
 }
 
 void Pod::setName(const string& s) {
+    // Le registre retrouve le pod par ce nom : il ne change pas tant que le pod y est
+    if (registered_) {
+        throw CloudException("Pod enregistre, renommage impossible : " + name_);
+    }
     name_ = s;
 }
 
+void Pod::setNode(const string& node) {
+    node_ = node;
+}
+
 void Pod::startAll() {
     for (auto& container: containers_) {
         container->start();
@@ -51,6 +60,22 @@ string Pod::getMetrics() const {
     return P;
 }
 
+double Pod::getCpuRequest() const {
+    double cpu = 0.0;
+    for (const auto& container: containers_) {
+        cpu += container->getCpu();
+    }
+    return cpu;
+}
+
+double Pod::getMemRequest() const {
+    double mem = 0.0;
+    for (const auto& container: containers_) {
+        mem += container->getMem();
+    }
+    return mem;
+}
+
 ostream& operator<<(ostream& os, const Pod& p) {
     os << p.getMetrics();
     return os;
@@ -59,9 +84,18 @@ ostream& operator<<(ostream& os, const Pod& p) {
 vector<unique_ptr<Container>>& Pod::getContainers() noexcept {
     return containers_;
 };
+const vector<unique_ptr<Container>>& Pod::getContainers() const noexcept {
+    return containers_;
+};
 unordered_map<string, string>& Pod::getLabels() noexcept {
     return labels_;
 };
-string Pod::getName() {
+const unordered_map<string, string>& Pod::getLabels() const noexcept {
+    return labels_;
+};
+const string& Pod::getName() const noexcept {
     return name_;
 }
+const string& Pod::getNode() const noexcept {
+    return node_;
+}
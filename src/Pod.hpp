@@ -13,25 +13,35 @@ using namespace std;
 class Pod {
     private:
         string name_;
+        string node_;  // nom du serveur qui heberge le pod (vide tant qu'il n'est pas place)
         vector<unique_ptr<Container>> containers_;
         unordered_map<string, string> labels_; // cle/valeur que l'on attache a un Pod
+        bool registered_;  // dans un PodRegistry, qui l'indexe par son nom
+
+        friend class PodRegistry;
     public:
         Pod(string name);
         ~Pod();
 
         void addContainer(unique_ptr<Container> c);
         void setLabel(const string& key, const string& value);
-        void setName(const string& s);
+        void setName(const string& s);  // throws CloudException once the pod is registered
+        void setNode(const string& node);
         void startAll();
         void stopAll();
 
         string getMetrics() const;
+        double getCpuRequest() const;  // somme des cpu de tous les containers
+        double getMemRequest() const;  // somme des mem de tous les containers
         friend ostream& operator<<(ostream& os, const Pod& p);
 
         // Getters 
         vector<unique_ptr<Container>>& getContainers() noexcept;
+        const vector<unique_ptr<Container>>& getContainers() const noexcept;
         unordered_map<string, string>& getLabels() noexcept;
-        string getName();
+        const unordered_map<string, string>& getLabels() const noexcept;
+        const string& getName() const noexcept;
+        const string& getNode() const noexcept;
 };
 
 
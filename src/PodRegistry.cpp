@@ -0,0 +1,221 @@
+#include "PodRegistry.hpp"
+#include "Exceptions.hpp"
+#include <algorithm>
+#include <functional>
+
+const PodRegistry::Slot* PodRegistry::slotFor(PodHandle handle) const noexcept {
+    if (handle.index >= slots_.size()) {
+        return nullptr;
+    }
+    const Slot& slot = slots_[handle.index];
+    // Une generation differente : le pod a ete retire depuis
+    return slot.generation == handle.generation ? &slot : nullptr;
+}
+
+uint32_t PodRegistry::hashOf(const string& name) noexcept {
+    const uint64_t hash = std::hash<string>()(name);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+size_t PodRegistry::lookup(const string& name, uint32_t hash) const noexcept {
+    if (control_.empty()) {
+        return NOT_FOUND;
+    }
+    const size_t mask = control_.size() - 1;
+    const uint8_t tag = tagOf(hash);
+    // Le nom n'est compare que si le tag et le hash complet sont egaux
+    for (size_t pos = homeOf(hash); control_[pos] != EMPTY; pos = (pos + 1) & mask) {
+        if (control_[pos] == tag) {
+            const Slot& slot = slots_[buckets_[pos]];
+            if (slot.hash == hash && pods_[slot.dense]->getName() == name) {
+                return pos;
+            }
+        }
+    }
+    return NOT_FOUND;
+}
+
+void PodRegistry::rehash(size_t buckets) {
+    control_.assign(buckets, EMPTY);
+    buckets_.assign(buckets, 0);
+    deleted_ = 0;
+    const size_t mask = buckets - 1;
+    for (uint32_t index: slotOf_) {
+        const uint32_t hash = slots_[index].hash;
+        size_t pos = homeOf(hash);
+        while (control_[pos] != EMPTY) {
+            pos = (pos + 1) & mask;
+        }
+        control_[pos] = tagOf(hash);
+        buckets_[pos] = index;
+    }
+}
+
+PodHandle PodRegistry::insert(unique_ptr<Pod>& pod) {
+    // Load factor (DELETED buckets included) kept under 1/2 : probe sequences stay short.
+    // The table only doubles if the live pods need it, otherwise it is just cleaned
+    if ((pods_.size() + deleted_ + 1) * 2 > control_.size()) {
+        const bool grow = (pods_.size() + 1) * 4 > control_.size();
+        rehash(grow ? max<size_t>(16, control_.size() * 2) : control_.size());
+    }
+    const string& name = pod->getName();
+    const uint32_t hash = hashOf(name);
+    const uint8_t tag = tagOf(hash);
+    const size_t mask = control_.size() - 1;
+
+    // Walk the whole probe sequence (a duplicate may sit after a DELETED bucket),
+    // the new pod then takes the first reusable bucket
+    size_t reuse = NOT_FOUND;
+    size_t pos = homeOf(hash);
+    for (; control_[pos] != EMPTY; pos = (pos + 1) & mask) {
+        if (control_[pos] == DELETED) {
+            reuse = reuse == NOT_FOUND ? pos : reuse;
+        } else if (control_[pos] == tag) {
+            const Slot& slot = slots_[buckets_[pos]];
+            if (slot.hash == hash && pods_[slot.dense]->getName() == name) {
+                throw DuplicatePodException("Pod deja present : " + name);
+            }
+        }
+    }
+    if (reuse != NOT_FOUND) {
+        pos = reuse;
+        --deleted_;
+    }
+
+    uint32_t index;
+    if (!freeSlots_.empty()) {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots_.size());
+        slots_.push_back({0, 0, 0});
+    }
+    slots_[index].dense = static_cast<uint32_t>(pods_.size());
+    slots_[index].hash = hash;
+
+    control_[pos] = tag;
+    buckets_[pos] = index;
+    slotOf_.push_back(index);
+    pod->registered_ = true;
+    pods_.push_back(move(pod));
+    return PodHandle{index, slots_[index].generation};
+}
+
+unique_ptr<Pod> PodRegistry::remove(PodHandle handle) {
+    const Slot* slot = slotFor(handle);
+    if (slot == nullptr) {
+        return nullptr;
+    }
+
+    const size_t mask = control_.size() - 1;
+    const uint8_t tag = tagOf(slot->hash);
+    size_t pos = homeOf(slot->hash);
+    while (control_[pos] != tag || buckets_[pos] != handle.index) {
+        pos = (pos + 1) & mask;
+    }
+    // No probe sequence goes through a bucket followed by EMPTY : it can be freed for good
+    if (control_[(pos + 1) & mask] == EMPTY) {
+        control_[pos] = EMPTY;
+    } else {
+        control_[pos] = DELETED;
+        ++deleted_;
+    }
+
+    const uint32_t dense = slot->dense;
+    unique_ptr<Pod> pod = move(pods_[dense]);
+    pod->registered_ = false;
+
+    // Swap-and-pop : the last pod fills the hole, its slot is told where it went
+    const uint32_t last = static_cast<uint32_t>(pods_.size() - 1);
+    if (dense != last) {
+        pods_[dense] = move(pods_[last]);
+        slotOf_[dense] = slotOf_[last];
+        slots_[slotOf_[dense]].dense = dense;
+    }
+    pods_.pop_back();
+    slotOf_.pop_back();
+
+    ++slots_[handle.index].generation;
+    freeSlots_.push_back(handle.index);
+    return pod;
+}
+
+unique_ptr<Pod> PodRegistry::remove(const string& name) {
+    return remove(handleOf(name));
+}
+
+Pod* PodRegistry::get(PodHandle handle) noexcept {
+    const Slot* slot = slotFor(handle);
+    return slot == nullptr ? nullptr : pods_[slot->dense].get();
+}
+
+const Pod* PodRegistry::get(PodHandle handle) const noexcept {
+    const Slot* slot = slotFor(handle);
+    return slot == nullptr ? nullptr : pods_[slot->dense].get();
+}
+
+Pod* PodRegistry::find(const string& name) noexcept {
+    return get(handleOf(name));
+}
+
+const Pod* PodRegistry::find(const string& name) const noexcept {
+    return get(handleOf(name));
+}
+
+PodHandle PodRegistry::handleOf(const string& name) const noexcept {
+    const size_t pos = lookup(name, hashOf(name));
+    if (pos == NOT_FOUND) {
+        return PodHandle();
+    }
+    const uint32_t index = buckets_[pos];
+    return PodHandle{index, slots_[index].generation};
+}
+
+bool PodRegistry::contains(const string& name) const noexcept {
+    return handleOf(name).valid();
+}
+
+void PodRegistry::reserve(size_t count) {
+    pods_.reserve(count);
+    slotOf_.reserve(count);
+    slots_.reserve(count);
+    size_t buckets = max<size_t>(16, control_.size());
+    while (buckets < count * 2) {
+        buckets *= 2;
+    }
+    if (buckets != control_.size()) {
+        rehash(buckets);
+    }
+}
+
+void PodRegistry::clear() noexcept {
+    // Outstanding handles must go stale : keep the slots, bump their generation
+    for (uint32_t index: slotOf_) {
+        ++slots_[index].generation;
+        freeSlots_.push_back(index);
+    }
+    pods_.clear();
+    slotOf_.clear();
+    fill(control_.begin(), control_.end(), EMPTY);
+    deleted_ = 0;
+}
+
+size_t PodRegistry::size() const noexcept {
+    return pods_.size();
+}
+
+bool PodRegistry::empty() const noexcept {
+    return pods_.empty();
+}
+
+const unique_ptr<Pod>& PodRegistry::back() const noexcept {
+    return pods_.back();
+}
+
+PodRegistry::const_iterator PodRegistry::begin() const noexcept {
+    return pods_.begin();
+}
+
+PodRegistry::const_iterator PodRegistry::end() const noexcept {
+    return pods_.end();
+}
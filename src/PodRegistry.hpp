@@ -0,0 +1,91 @@
+#ifndef PODREGISTRY_HPP
+#define PODREGISTRY_HPP
+
+#include "Pod.hpp"
+#include <cstdint>
+
+// Stable reference to a registered pod. It goes stale (get() returns nullptr)
+// once the pod is removed, even if its slot is reused by another pod.
+struct PodHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const noexcept { return index != UINT32_MAX; }
+    bool operator==(const PodHandle& other) const noexcept {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const PodHandle& other) const noexcept { return !(*this == other); }
+};
+
+/*
+    Pods of a cluster, by name :
+
+        pods_      dense array, what iteration walks (no holes)
+        slots_     handle.index -> position in pods_, generation and name hash of the slot
+        control_   open addressing (linear probing), one byte per bucket : 7 bits of the
+                   name hash, EMPTY or DELETED
+        buckets_   slot index of each used bucket
+
+    insert, find and remove are O(1) ; remove moves the last pod into the hole
+    (swap-and-pop), so the iteration order is not the insertion order.
+    An insert only reads control_ (1 byte per bucket, it stays in cache) and writes
+    buckets_ : the other arrays are read when a 7-bit tag matches.
+    The index keeps no copy of the names : Pod::setName() throws while the pod is registered.
+    Iteration only gives const unique_ptr<Pod>& : pods go in and out through insert / remove.
+    A Pod* stays valid until that pod is removed ; a PodHandle also tells when it was.
+*/
+class PodRegistry {
+    private:
+        struct Slot {
+            uint32_t dense;        // position in pods_ while the slot is used
+            uint32_t generation;   // bumped on every removal
+            uint32_t hash;         // of the name : rehash and removal never read the pods
+        };
+
+        static constexpr uint8_t EMPTY = 0x80;
+        static constexpr uint8_t DELETED = 0xFE;
+        static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+        vector<unique_ptr<Pod>> pods_;
+        vector<uint32_t> slotOf_;       // pods_[i] lives in slots_[slotOf_[i]]
+        vector<Slot> slots_;
+        vector<uint32_t> freeSlots_;
+        vector<uint8_t> control_;       // size is a power of two
+        vector<uint32_t> buckets_;      // same size as control_
+        size_t deleted_ = 0;            // DELETED buckets, they count in the load
+
+        static uint32_t hashOf(const string& name) noexcept;
+        static uint8_t tagOf(uint32_t hash) noexcept { return hash & 0x7F; }
+        size_t homeOf(uint32_t hash) const noexcept { return (hash >> 7) & (control_.size() - 1); }
+        const Slot* slotFor(PodHandle handle) const noexcept;
+        size_t lookup(const string& name, uint32_t hash) const noexcept;  // bucket, or NOT_FOUND
+        void rehash(size_t buckets);
+
+    public:
+        using iterator = vector<unique_ptr<Pod>>::const_iterator;
+        using const_iterator = vector<unique_ptr<Pod>>::const_iterator;
+
+        // Takes ownership on success ; throws DuplicatePodException (pod left to the caller) if the name is taken
+        PodHandle insert(unique_ptr<Pod>& pod);
+        // Returns nullptr if the handle is stale / the name unknown
+        unique_ptr<Pod> remove(PodHandle handle);
+        unique_ptr<Pod> remove(const string& name);
+
+        Pod* get(PodHandle handle) noexcept;
+        const Pod* get(PodHandle handle) const noexcept;
+        Pod* find(const string& name) noexcept;
+        const Pod* find(const string& name) const noexcept;
+        PodHandle handleOf(const string& name) const noexcept;  // invalid handle if unknown
+        bool contains(const string& name) const noexcept;
+
+        void reserve(size_t count);
+        void clear() noexcept;
+
+        size_t size() const noexcept;
+        bool empty() const noexcept;
+        const unique_ptr<Pod>& back() const noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "SchedulingQueue.hpp"
+#include "Exceptions.hpp"
+#include <algorithm>
+#include <chrono>
+
+static double steadySeconds() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+SchedulingQueue::SchedulingQueue(KubernetesCluster& cluster, function<double()> clock)
+    : cluster_(cluster),
+        clock_(clock ? move(clock) : steadySeconds),
+        depth_(0),
+        parked_(0),
+        scheduled_(0),
+        retries_(0),
+        wastedRetries_(0),
+        rejectedCount_(0),
+        totalWait_(0.0),
+        maxWait_(0.0),
+        retrying_(false)
+{
+    cluster_.addListener(this);
+}
+
+SchedulingQueue::~SchedulingQueue() {
+    cluster_.removeListener(this);
+}
+
+bool SchedulingQueue::submit(unique_ptr<Pod>& pod) {
+    if (contains(pod->getName())) {
+        throw DuplicatePodException("Pod deja en attente : " + pod->getName());
+    }
+    try {
+        cluster_.schedulePod(pod);
+        return true;
+    } catch (const DuplicatePodException&) {
+        throw;  // waiting would not help, the caller keeps the pod
+    } catch (const AllocationException&) {
+        park(pod);
+        return false;
+    }
+}
+
+void SchedulingQueue::park(unique_ptr<Pod>& pod) {
+    Shape shape(pod->getCpuRequest(), pod->getMemRequest());
+    if (!names_.emplace(pod->getName(), shape).second) {
+        throw DuplicatePodException("Pod deja en attente : " + pod->getName());
+    }
+    shapes_[shape].push_back({move(pod), clock_()});
+    ++depth_;
+    ++parked_;
+}
+
+unique_ptr<Pod> SchedulingQueue::remove(const string& name) {
+    auto it = names_.find(name);
+    if (it == names_.end()) {
+        return nullptr;
+    }
+    auto shape = shapes_.find(it->second);
+    auto& waiting = shape->second;
+    auto parked = find_if(waiting.begin(), waiting.end(),
+                          [&](const Parked& p) { return p.pod->getName() == name; });
+    unique_ptr<Pod> pod = move(parked->pod);
+    waiting.erase(parked);
+    if (waiting.empty()) {
+        shapes_.erase(shape);
+    }
+    names_.erase(it);
+    --depth_;
+    return pod;
+}
+
+bool SchedulingQueue::contains(const string& name) const {
+    return names_.count(name) != 0;
+}
+
+/*
+    Only shapes with cpu <= free cpu of the server are visited (the map is sorted),
+    and inside a shape the pods leave in FIFO order while they still fit.
+*/
+void SchedulingQueue::retryFor(const Server& server) {
+    auto it = shapes_.begin();
+    while (it != shapes_.end() && it->first.first <= server.getAvailableCpu()) {
+        auto& waiting = it->second;
+        while (!waiting.empty() && server.canAllocate(it->first.first, it->first.second)) {
+            ++retries_;
+            const Pod* pod = waiting.front().pod.get();   // still alive once placed or set aside
+            bool setAside = false;
+            try {
+                cluster_.schedulePod(waiting.front().pod);
+            } catch (const DuplicatePodException&) {
+                // Its name was taken while it waited : retrying will never place it
+                setAside = true;
+            } catch (const AllocationException&) {
+                ++wastedRetries_;
+                break;
+            } catch (...) {
+                // Nothing may escape the cluster's listener loop. A pod refused for another
+                // reason is set aside and the others keep going ;
+                // if the pod was placed before the error, it counts as scheduled
+                setAside = waiting.front().pod != nullptr;
+            }
+            if (setAside) {
+                rejected_.push_back(move(waiting.front().pod));
+                names_.erase(pod->getName());
+                ++rejectedCount_;
+                --depth_;
+                waiting.pop_front();
+                continue;
+            }
+            names_.erase(pod->getName());
+            const double wait = clock_() - waiting.front().since;
+            totalWait_ += wait;
+            maxWait_ = max(maxWait_, wait);
+            ++scheduled_;
+            --depth_;
+            waiting.pop_front();
+        }
+        it = waiting.empty() ? shapes_.erase(it) : next(it);
+    }
+}
+
+vector<unique_ptr<Pod>> SchedulingQueue::takeRejected() {
+    vector<unique_ptr<Pod>> rejected;
+    rejected.swap(rejected_);
+    return rejected;
+}
+
+void SchedulingQueue::onServerAdded(const Server& server) {
+    touched_.push_back(&server);
+}
+
+void SchedulingQueue::onPodEvicted(const Pod&, const Server& server) {
+    touched_.push_back(&server);
+}
+
+void SchedulingQueue::afterEvent() {
+    // The schedulePod() calls of a retry notify again : nothing to do in those
+    if (retrying_) {
+        return;
+    }
+    retrying_ = true;
+    while (!touched_.empty()) {
+        const Server* server = touched_.back();
+        touched_.pop_back();
+        retryFor(*server);
+    }
+    retrying_ = false;
+}
+
+size_t SchedulingQueue::depth() const noexcept {
+    return depth_;
+}
+
+size_t SchedulingQueue::shapeCount() const noexcept {
+    return shapes_.size();
+}
+
+QueueStats SchedulingQueue::getStats() const {
+    QueueStats stats;
+    stats.depth = depth_;
+    stats.parked = parked_;
+    stats.scheduled = scheduled_;
+    stats.retries = retries_;
+    stats.wastedRetries = wastedRetries_;
+    stats.rejected = rejectedCount_;
+    stats.meanWait = scheduled_ > 0 ? totalWait_ / static_cast<double>(scheduled_) : 0.0;
+    stats.maxWait = maxWait_;
+
+    // The oldest pod of each shape is at the front of its deque
+    const double now = clock_();
+    for (const auto& entry: shapes_) {
+        stats.oldestWait = max(stats.oldestWait, now - entry.second.front().since);
+    }
+    return stats;
+}
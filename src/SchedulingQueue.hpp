@@ -0,0 +1,81 @@
+#ifndef SCHEDULINGQUEUE_HPP
+#define SCHEDULINGQUEUE_HPP
+
+#include "KubernetesCluster.hpp"
+#include <deque>
+#include <functional>
+#include <map>
+
+struct QueueStats {
+    size_t depth = 0;            // pods parked right now
+    size_t parked = 0;           // pods ever parked
+    size_t scheduled = 0;        // parked pods placed later by a retry
+    size_t retries = 0;          // schedulePod calls made by the queue
+    size_t wastedRetries = 0;    // retries that still failed
+    size_t rejected = 0;         // parked pods set aside by a retry failing for another reason
+    double meanWait = 0.0;       // seconds between parking and placement
+    double maxWait = 0.0;
+    double oldestWait = 0.0;     // age of the oldest pod still parked
+};
+
+/*
+    Queue of unschedulable pods.
+
+    Pods are parked by resource shape (total cpu, total mem). Nothing is retried
+    on a timer : only when a server gets free capacity (pod evicted, server added)
+    and only the shapes that fit in that server's free capacity now.
+    The callbacks only note the server ; the retries run from afterEvent(), once every
+    listener has heard about the event, and they never throw : a pod refused for
+    another reason than capacity is set aside, see takeRejected().
+*/
+class SchedulingQueue : public ClusterListener {
+    private:
+        struct Parked {
+            unique_ptr<Pod> pod;
+            double since;
+        };
+        using Shape = pair<double, double>;  // (cpu, mem), sorted by cpu first
+
+        KubernetesCluster& cluster_;
+        function<double()> clock_;
+        map<Shape, deque<Parked>> shapes_;
+        unordered_map<string, Shape> names_;  // parked pod -> its shape
+        size_t depth_;
+
+        size_t parked_;
+        size_t scheduled_;
+        size_t retries_;
+        size_t wastedRetries_;
+        vector<unique_ptr<Pod>> rejected_;
+        size_t rejectedCount_;
+        double totalWait_;
+        double maxWait_;
+        vector<const Server*> touched_;  // servers with new free capacity, not retried yet
+        bool retrying_;
+
+        void retryFor(const Server& server);
+
+    public:
+        SchedulingQueue(KubernetesCluster& cluster, function<double()> clock = nullptr);
+        ~SchedulingQueue() override;
+
+        // Tries to schedule the pod now, parks it if it does not fit ; returns true if placed.
+        // A name already parked or placed throws DuplicatePodException, the pod stays with the caller
+        bool submit(unique_ptr<Pod>& pod);
+        void park(unique_ptr<Pod>& pod);
+        // Takes a parked pod out of the queue (nullptr if it is not parked)
+        unique_ptr<Pod> remove(const string& name);
+        bool contains(const string& name) const;
+        // Parked pods a retry could not place for another reason than capacity, given back
+        vector<unique_ptr<Pod>> takeRejected();
+
+        void onServerAdded(const Server& server) override;
+        void onPodEvicted(const Pod& pod, const Server& server) override;
+        void afterEvent() override;
+
+        size_t depth() const noexcept;
+        size_t shapeCount() const noexcept;
+        QueueStats getStats() const;
+};
+
+#endif
@@ -1,16 +1,18 @@
 #include "Server.hpp"
+#include <algorithm>
 
 Server::Server(string id, double initial_cpu, double initial_mem) 
     : Resource(id, initial_cpu, initial_mem), 
         available_cpu_(initial_cpu), 
         available_mem_(initial_mem),
         initial_cpu_(initial_cpu),
-        initial_mem_(initial_mem) {}
+        initial_mem_(initial_mem),
+        pods_(0) {}
 
 Server::~Server() = default;
 
 void Server::allocate(double cpu, double mem) {
-    if ((cpu <= available_cpu_) && (mem <= available_mem_)) {
+    if (canAllocate(cpu, mem)) {
         available_cpu_ -= cpu;
         available_mem_ -= mem;
     } else {
@@ -18,11 +20,29 @@ void Server::allocate(double cpu, double mem) {
     }
 }
 
+void Server::release(double cpu, double mem) {
+    // Clamp so that rounding on repeated allocate/release never exceeds the initial capacity
+    available_cpu_ = min(available_cpu_ + cpu, initial_cpu_);
+    available_mem_ = min(available_mem_ + mem, initial_mem_);
+}
+
+bool Server::canAllocate(double cpu, double mem) const noexcept {
+    return (cpu <= available_cpu_) && (mem <= available_mem_);
+}
+
 void Server::reset() {
     available_cpu_ = initial_cpu_;
     available_mem_ = initial_mem_;
 }
 
+void Server::addPod() noexcept {
+    ++pods_;
+}
+
+void Server::removePod() noexcept {
+    --pods_;
+}
+
 void Server::start() {
     active_ = true;
 }
@@ -58,4 +78,8 @@ double Server::getAvailableCpu() const {
 
 double Server::getAvailableMem() const {
     return available_mem_;
-}
\ No newline at end of file
+}
+
+size_t Server::getPodCount() const noexcept {
+    return pods_;
+}
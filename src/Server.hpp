@@ -10,13 +10,19 @@ class Server : public Resource {
         double available_mem_;
         double initial_cpu_;
         double initial_mem_;
+        size_t pods_;  // pods places par le cluster
     
     public:
         Server(string id, double initial_cpu, double initial_mem);
         ~Server() override;
 
         void allocate(double cpu, double mem);
+        void release(double cpu, double mem);  // Give back a previous allocation
+        bool canAllocate(double cpu, double mem) const noexcept;
         void reset();  // Reset resources to initial values
+        // Kept by KubernetesCluster, so an empty server is known without scanning the pods
+        void addPod() noexcept;
+        void removePod() noexcept;
 
         void start() override;
         void stop() override;
@@ -29,6 +35,7 @@ class Server : public Resource {
         double getInitialMem() const;
         double getAvailableCpu() const;
         double getAvailableMem() const;
+        size_t getPodCount() const noexcept;
 
 };
 
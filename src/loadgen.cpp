@@ -0,0 +1,179 @@
+// Load generator for "cloudsim --serve".
+//
+//   cloudsim_loadgen --print <requests>            writes the workload on stdout
+//                                                  (cloudsim_loadgen --print 100000 | ./src/cloudsim --serve > /dev/null)
+//   cloudsim_loadgen --socket <path> <requests>    sends it to a running "cloudsim --serve --socket <path>"
+//                                                  and measures throughput and latency on the client side
+#include "Instrumentation.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const int SERVERS = 64;
+static const size_t CHUNK = 256;   // requests per write()
+static const size_t MAX_LIVE = 6000;  // keeps the 64 servers around 75% full
+
+// 64 servers, then 70% schedule / 20% evict / 10% query (evict when the cluster is full)
+std::vector<std::string> MakeWorkload(size_t requests) {
+    std::vector<std::string> lines;
+    lines.reserve(requests + SERVERS);
+    for (int i = 0; i < SERVERS; ++i) {
+        lines.push_back("add-server node" + std::to_string(i) + " 64 128");
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> containers(1, 3);
+    std::vector<size_t> live;
+    size_t next = 0;
+
+    while (lines.size() < requests + SERVERS) {
+        const int p = percent(rng);
+        if ((p < 20 || live.size() >= MAX_LIVE) && !live.empty()) {
+            std::uniform_int_distribution<size_t> pick(0, live.size() - 1);
+            const size_t i = pick(rng);
+            lines.push_back("evict pod" + std::to_string(live[i]));
+            live[i] = live.back();
+            live.pop_back();
+        } else if (p < 30 && !live.empty()) {
+            std::uniform_int_distribution<size_t> pick(0, live.size() - 1);
+            lines.push_back("query pod pod" + std::to_string(live[pick(rng)]));
+        } else {
+            std::string line = "schedule pod" + std::to_string(next);
+            for (int c = containers(rng); c > 0; --c) {
+                line += " 0.25:0.5:nginx";
+            }
+            lines.push_back(line);
+            live.push_back(next++);
+        }
+    }
+    return lines;
+}
+
+int Connect(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "cannot connect to " << path << ": " << strerror(errno) << std::endl;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+bool WriteAll(int fd, const std::string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int RunSocket(const std::string& path, size_t requests) {
+    int fd = Connect(path);
+    if (fd < 0) {
+        return 1;
+    }
+    std::vector<std::string> lines = MakeWorkload(requests);
+    lines.push_back("stats");
+    lines.push_back("quit");
+
+    // Responses come back in order : the sender queues the send time of every request
+    std::mutex lock;
+    std::deque<uint64_t> sentAt;
+    LatencyHistogram latency;
+
+    const uint64_t start = Instrumentation::nowNs();
+    std::thread sender([&]() {
+        for (size_t i = 0; i < lines.size(); i += CHUNK) {
+            std::string chunk;
+            const size_t end = std::min(lines.size(), i + CHUNK);
+            for (size_t j = i; j < end; ++j) {
+                chunk += lines[j];
+                chunk += '\n';
+            }
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                sentAt.insert(sentAt.end(), end - i, Instrumentation::nowNs());
+            }
+            if (!WriteAll(fd, chunk)) {
+                break;
+            }
+        }
+    });
+
+    std::string buffer, last, serverStats;
+    std::vector<char> chunk(64 * 1024);
+    size_t received = 0, errors = 0;
+    while (received < lines.size()) {
+        ssize_t n = ::read(fd, chunk.data(), chunk.size());
+        if (n <= 0) {
+            break;
+        }
+        const uint64_t now = Instrumentation::nowNs();
+        buffer.append(chunk.data(), static_cast<size_t>(n));
+        size_t pos, begin = 0;
+        while ((pos = buffer.find('\n', begin)) != std::string::npos) {
+            last = buffer.substr(begin, pos - begin);
+            begin = pos + 1;
+            if (last.compare(0, 5, "error") == 0) {
+                ++errors;
+            }
+            if (received == lines.size() - 2) {
+                serverStats = last;
+            }
+            std::lock_guard<std::mutex> guard(lock);
+            latency.record(now - sentAt.front());
+            sentAt.pop_front();
+            ++received;
+        }
+        buffer.erase(0, begin);
+    }
+    const double seconds = static_cast<double>(Instrumentation::nowNs() - start) / 1e9;
+    sender.join();
+    ::close(fd);
+
+    std::cout << "requests: " << received << " (" << errors << " errors) in " << seconds << " s\n";
+    std::cout << "client rps: " << static_cast<uint64_t>(static_cast<double>(received) / seconds) << "\n";
+    std::cout << "client latency us: p50=" << latency.percentile(50) / 1000
+              << " p99=" << latency.percentile(99) / 1000
+              << " max=" << latency.max() / 1000 << "\n";
+    std::cout << "server: " << serverStats << "\n";
+    return received == lines.size() ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::string(argv[1]) == "--print") {
+        for (const auto& line: MakeWorkload(std::stoul(argv[2]))) {
+            std::cout << line << '\n';
+        }
+        std::cout << "stats\nquit\n";
+        return 0;
+    }
+    if (argc == 4 && std::string(argv[1]) == "--socket") {
+        return RunSocket(argv[2], std::stoul(argv[3]));
+    }
+    std::cerr << "usage: " << argv[0] << " --print <requests> | --socket <path> <requests>" << std::endl;
+    return 2;
+}
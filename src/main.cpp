@@ -1,9 +1,13 @@
 #include "CloudUtil.hpp"
+#include "CloudService.hpp"
+#include "ClusterExport.hpp"
+#include "SchedulingQueue.hpp"
 #include "KubernetesCluster.hpp"
 #include "Pod.hpp"
 #include "Container.hpp"
 #include "Server.hpp"
 #include "Exceptions.hpp"
+#include "Instrumentation.hpp"
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <memory>
@@ -14,6 +18,7 @@ using json = nlohmann::json;
 
 
 std::vector<std::unique_ptr<Pod>> ParseJsonFile(const std::string& filename) {
+    CLOUDSIM_TIMED(Parse);
 
     std::vector<std::unique_ptr<Pod>> pods;
 
@@ -50,26 +55,59 @@ std::vector<std::unique_ptr<Pod>> ParseJsonFile(const std::string& filename) {
 }
 
 
+// cloudsim --serve [--socket <path>] : persistent placement service (stdin/stdout or Unix socket)
+int RunService(int argc, char* argv[]) {
+    CloudService service;
+    if (argc > 3 && std::string(argv[2]) == "--socket") {
+        std::cerr << "=== cloudsim listening on " << argv[3] << " ===" << std::endl;
+        service.serveUnixSocket(argv[3]);
+    } else {
+        service.serve(0, 1);
+    }
+    std::cerr << "=== Service stats: " << service.getStats().toString() << " ===" << std::endl;
+    return 0;
+}
+
+
 int main(int argc, char* argv[]) {
     try {
+        if (argc > 1 && std::string(argv[1]) == "--serve") {
+            return RunService(argc, argv);
+        }
+
+        // cloudsim --export <prefix> : also writes the columnar tables (prefix + servers.col, ...)
+        const std::string exportPrefix = argc > 2 && std::string(argv[1]) == "--export" ? argv[2] : "";
+
         std::vector<std::unique_ptr<Pod>> pods;
 
         std::cout << "=== Parsing pods from JSON file ===" << std::endl;
         pods = ParseJsonFile("../data/pods.JSON");
 
         KubernetesCluster cluster("My cluster");
-        cluster.addServer(std::make_shared("Server1", 4.0, 8.0));
-        cluster.addServer(std::make_shared("Server2", 4.0, 8.0));
-        cluster.addServer(std::make_shared("Server3", 2.0, 4.0));
+        cluster.addServer(std::make_shared<Server>("Server1", 4.0, 8.0));
+        cluster.addServer(std::make_shared<Server>("Server2", 4.0, 8.0));
+        cluster.addServer(std::make_shared<Server>("Server3", 2.0, 4.0));
 
         CloudUtil util;
+        SchedulingQueue queue(cluster);
 
         std::cout << "=== Deploying pods to cluster ===" << std::endl;
-        util.deployPods(cluster, pods);
+        util.deployPods(queue, pods);
+        std::cout << "Pending pods: " << queue.depth() << std::endl;
 
         std::cout << "=== Cluster Metrics ===" << std::endl;
         util.display(cluster);
 
+        if (!exportPrefix.empty()) {
+            const uint64_t bytes = exportCluster(cluster, exportPrefix);
+            std::cout << "=== Exported " << bytes << " bytes to " << exportPrefix << "*.col ===" << std::endl;
+        }
+
+        if (Instrumentation::compiledIn()) {
+            std::cout << "=== Instrumentation ===" << std::endl;
+            std::cout << Instrumentation::collect().toString();
+        }
+
         std::cout << "=== Deployement completed successfully! ===" << std::endl;
 
     } catch (const FileException& e) {
@@ -0,0 +1,14 @@
+#ifndef TESTHELPERS_HPP
+#define TESTHELPERS_HPP
+
+#include "Pod.hpp"
+using namespace std;
+
+// Pod with a single container asking for (cpu, mem)
+inline unique_ptr<Pod> makePod(const string& name, double cpu, double mem) {
+    auto pod = make_unique<Pod>(name);
+    pod->addContainer(make_unique<Container>(name + "-c", cpu, mem, "img"));
+    return pod;
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "CloudService.hpp"
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
+
+TEST(CloudServiceTest, ParseRequests) {
+    ServiceRequest r = CloudService::parse("add-server n1 4 8.5");
+    EXPECT_EQ(r.kind, ServiceRequest::Kind::AddServer);
+    EXPECT_EQ(r.name, "n1");
+    EXPECT_DOUBLE_EQ(r.mem, 8.5);
+
+    r = CloudService::parse("schedule web 1:0.5:nginx 0.5:0.25");
+    ASSERT_EQ(r.kind, ServiceRequest::Kind::Schedule);
+    ASSERT_NE(r.pod, nullptr);
+    EXPECT_EQ(r.pod->getContainers().size(), 2u);
+    EXPECT_DOUBLE_EQ(r.pod->getCpuRequest(), 1.5);
+
+    EXPECT_EQ(CloudService::parse("query pod web").kind, ServiceRequest::Kind::QueryPod);
+    EXPECT_EQ(CloudService::parse("schedule web 1:x").kind, ServiceRequest::Kind::Invalid);
+    EXPECT_EQ(CloudService::parse("add-server n1 -1 2").kind, ServiceRequest::Kind::Invalid);
+    EXPECT_EQ(CloudService::parse("reboot").kind, ServiceRequest::Kind::Invalid);
+}
+
+TEST(CloudServiceTest, ExecuteKeepsStateBetweenRequests) {
+    CloudService service;
+    auto run = [&](const string& line) {
+        ServiceRequest r = CloudService::parse(line);
+        return service.execute(r);
+    };
+
+    EXPECT_EQ(run("add-server n1 2 4"), "ok");
+    EXPECT_EQ(run("add-server n1 2 4"), "error server n1 already exists");
+    EXPECT_EQ(run("schedule a 1:1"), "ok n1");
+    EXPECT_EQ(run("schedule b 2:1"), "pending");
+    EXPECT_EQ(run("query pod b"), "pending");
+    EXPECT_EQ(run("evict a"), "ok");
+    // L'eviction libere n1, b est place par la queue
+    EXPECT_EQ(run("query pod b"), "ok n1");
+    EXPECT_EQ(run("query server n1"), "ok cpu=0 mem=3");
+    EXPECT_EQ(run("evict ghost").rfind("error", 0), 0u);
+    EXPECT_EQ(run("query cluster").rfind("ok nodes=1 pods=1 pending=0", 0), 0u);
+}
+
+TEST(CloudServiceTest, PendingStateComesFromTheQueue) {
+    CloudService service;
+    auto run = [&](const string& line) {
+        ServiceRequest r = CloudService::parse(line);
+        return service.execute(r);
+    };
+
+    EXPECT_EQ(run("add-server n1 2 4"), "ok");
+    EXPECT_EQ(run("schedule a 2:1"), "ok n1");
+    EXPECT_EQ(run("schedule b 2:1"), "pending");
+    EXPECT_EQ(run("schedule b 1:1").rfind("error", 0), 0u);   // deja en attente
+    EXPECT_EQ(run("evict a"), "ok");      // b est place par la queue
+    EXPECT_EQ(run("evict b"), "ok");
+    EXPECT_EQ(run("query pod b"), "error unknown pod b");
+    EXPECT_EQ(run("query cluster").rfind("ok nodes=1 pods=0 pending=0", 0), 0u);
+
+    // Evicting a parked pod cancels it
+    EXPECT_EQ(run("schedule big 8:1"), "pending");
+    EXPECT_EQ(run("evict big"), "ok");
+    EXPECT_EQ(run("query pod big"), "error unknown pod big");
+    EXPECT_EQ(run("query cluster").rfind("ok nodes=1 pods=0 pending=0", 0), 0u);
+}
+
+TEST(CloudServiceTest, ClientClosingMidStreamDoesNotKillTheService) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    CloudService service;
+    thread server([&]() { service.serve(fds[0], fds[0]); });
+
+    // The client sends what the socket takes, never reads the answers and goes away
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    string script = "add-server n1 4 8\n";
+    for (int i = 0; i < 20000; ++i) {
+        script += "query cluster\n";
+    }
+    size_t sent = 0;
+    ssize_t n;
+    while (sent < script.size() && (n = write(fds[1], script.data() + sent, script.size() - sent)) > 0) {
+        sent += static_cast<size_t>(n);
+    }
+    close(fds[1]);
+
+    // Without MSG_NOSIGNAL the process dies of SIGPIPE here
+    server.join();
+    close(fds[0]);
+    EXPECT_FALSE(service.isShutdown());
+    ServiceRequest query = CloudService::parse("query server n1");
+    EXPECT_EQ(service.execute(query), "ok cpu=4 mem=8");
+}
+
+TEST(CloudServiceTest, ServePipelineOverPipes) {
+    int requests[2];
+    int responses[2];
+    ASSERT_EQ(pipe(requests), 0);
+    ASSERT_EQ(pipe(responses), 0);
+
+    string script = "add-server n1 4 8\n";
+    for (int i = 0; i < 200; ++i) {
+        script += "schedule p" + to_string(i) + " 0.01:0.01\n";
+    }
+    script += "query cluster\nquit\nschedule ignored 1:1\n";
+    ASSERT_EQ(write(requests[1], script.data(), script.size()), static_cast<ssize_t>(script.size()));
+    close(requests[1]);
+
+    CloudService service;
+    service.serve(requests[0], responses[1]);
+    close(requests[0]);
+    close(responses[1]);
+
+    string out;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(responses[0], buffer, sizeof(buffer))) > 0) {
+        out.append(buffer, static_cast<size_t>(n));
+    }
+    close(responses[0]);
+
+    size_t lines = 0;
+    for (char c: out) {
+        lines += c == '\n';
+    }
+    EXPECT_EQ(lines, 203u);   // tout jusqu'a quit inclus
+    EXPECT_NE(out.find("ok nodes=1 pods=200 pending=0"), string::npos);
+    EXPECT_EQ(out.find("error"), string::npos);
+
+    ServiceStats stats = service.getStats();
+    EXPECT_EQ(stats.requests, 203u);
+    EXPECT_GE(stats.batches, 1u);
+    EXPECT_GT(stats.p99Ns, 0u);
+}
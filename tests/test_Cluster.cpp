@@ -74,4 +74,144 @@ TEST(ClusterTest, GetMetricsAndStream) {
     std::ostringstream oss;
     oss << cluster;
     EXPECT_EQ(oss.str(), m);
-}
\ No newline at end of file
+}
+
+TEST(ClusterTest, FailedScheduleKeepsOtherAllocations) {
+    KubernetesCluster cluster("c");
+    auto srv = make_shared<Server>("n1", 4.0, 4.0);
+    cluster.addServer(srv);
+
+    auto p1 = make_unique<Pod>("p1");
+    p1->addContainer(make_unique<Container>("c1", 2.0, 2.0, "img"));
+    cluster.schedulePod(p1);
+
+    auto p2 = make_unique<Pod>("p2");
+    p2->addContainer(make_unique<Container>("c2", 1.0, 1.0, "img"));
+    p2->addContainer(make_unique<Container>("c3", 3.0, 1.0, "img"));
+    EXPECT_THROW({cluster.schedulePod(p2);}, AllocationException);
+
+    // p1 est toujours alloue sur n1
+    EXPECT_DOUBLE_EQ(srv->getAvailableCpu(), 2.0);
+    EXPECT_DOUBLE_EQ(srv->getAvailableMem(), 2.0);
+}
+
+TEST(ClusterTest, GangSchedulesWholeGroupAcrossServers) {
+    KubernetesCluster cluster("c");
+    auto n1 = make_shared<Server>("n1", 2.0, 2.0);
+    auto n2 = make_shared<Server>("n2", 2.0, 2.0);
+    cluster.addServer(n1);
+    cluster.addServer(n2);
+
+    vector<unique_ptr<Pod>> gang;
+    for (int i = 0; i < 2; ++i) {
+        gang.push_back(make_unique<Pod>("worker" + to_string(i)));
+        gang.back()->addContainer(make_unique<Container>("c" + to_string(i), 1.5, 1.0, "img"));
+    }
+
+    EXPECT_NO_THROW({cluster.scheduleGang(gang);});
+    EXPECT_EQ(cluster.getPods().size(), 2u);
+    EXPECT_EQ(gang[0], nullptr);
+    EXPECT_EQ(gang[1], nullptr);
+    EXPECT_DOUBLE_EQ(n1->getAvailableCpu(), 0.5);
+    EXPECT_DOUBLE_EQ(n2->getAvailableCpu(), 0.5);
+}
+
+TEST(ClusterTest, GangRollsBackWhenGroupDoesNotFit) {
+    KubernetesCluster cluster("c");
+    auto n1 = make_shared<Server>("n1", 4.0, 4.0);
+    auto n2 = make_shared<Server>("n2", 2.0, 2.0);
+    cluster.addServer(n1);
+    cluster.addServer(n2);
+
+    auto existing = make_unique<Pod>("existing");
+    existing->addContainer(make_unique<Container>("e", 1.0, 1.0, "img"));
+    cluster.schedulePod(existing);
+
+    vector<unique_ptr<Pod>> gang;
+    for (int i = 0; i < 3; ++i) {
+        gang.push_back(make_unique<Pod>("worker" + to_string(i)));
+        gang.back()->addContainer(make_unique<Container>("c" + to_string(i), 2.0, 1.0, "img"));
+    }
+
+    EXPECT_THROW({cluster.scheduleGang(gang);}, AllocationException);
+
+    // Aucun membre n'est deploye et le pod existant garde sa place
+    EXPECT_EQ(cluster.getPods().size(), 1u);
+    for (const auto& p: gang) {
+        EXPECT_NE(p, nullptr);
+    }
+    EXPECT_DOUBLE_EQ(n1->getAvailableCpu(), 3.0);
+    EXPECT_DOUBLE_EQ(n1->getAvailableMem(), 3.0);
+    EXPECT_DOUBLE_EQ(n2->getAvailableCpu(), 2.0);
+    EXPECT_DOUBLE_EQ(n2->getAvailableMem(), 2.0);
+}
+
+TEST(ClusterTest, EvictPodReleasesCapacity) {
+    KubernetesCluster cluster("c");
+    auto srv = make_shared<Server>("n1", 4.0, 4.0);
+    cluster.addServer(srv);
+
+    auto pod = make_unique<Pod>("p1");
+    pod->addContainer(make_unique<Container>("c1", 3.0, 1.0, "img"));
+    cluster.schedulePod(pod);
+    EXPECT_THROW({cluster.removeServer("n1");}, CloudException);
+
+    unique_ptr<Pod> back = cluster.evictPod("p1");
+    ASSERT_NE(back, nullptr);
+    EXPECT_TRUE(back->getNode().empty());
+    EXPECT_TRUE(cluster.getPods().empty());
+    EXPECT_DOUBLE_EQ(srv->getAvailableCpu(), 4.0);
+    EXPECT_THROW({cluster.evictPod("p1");}, CloudException);
+
+    EXPECT_NO_THROW({cluster.removeServer("n1");});
+    EXPECT_TRUE(cluster.getNodes().empty());
+}
+
+TEST(ClusterTest, ServersCountTheirPods) {
+    KubernetesCluster cluster("c");
+    auto n1 = make_shared<Server>("n1", 4.0, 4.0);
+    cluster.addServer(n1);
+
+    vector<unique_ptr<Pod>> gang;
+    for (const string name: {"g1", "g2"}) {
+        gang.push_back(make_unique<Pod>(name));
+        gang.back()->addContainer(make_unique<Container>("c", 1.0, 1.0, "img"));
+    }
+    cluster.scheduleGang(gang);
+    auto pod = make_unique<Pod>("p");
+    cluster.schedulePod(pod);
+    EXPECT_EQ(n1->getPodCount(), 3u);
+
+    cluster.evictPod("g1");
+    cluster.evictPod("p");
+    EXPECT_EQ(n1->getPodCount(), 1u);
+    EXPECT_THROW({cluster.removeServer("n1");}, CloudException);
+    cluster.evictPod("g2");
+    EXPECT_NO_THROW({cluster.removeServer("n1");});
+}
+
+TEST(ClusterTest, PodNamesAreUnique) {
+    KubernetesCluster cluster("c");
+    auto srv = make_shared<Server>("n1", 8.0, 8.0);
+    cluster.addServer(srv);
+
+    auto first = make_unique<Pod>("web");
+    first->addContainer(make_unique<Container>("c", 1.0, 1.0, "img"));
+    cluster.schedulePod(first);
+    ASSERT_NE(cluster.getPods().find("web"), nullptr);
+    EXPECT_EQ(cluster.getPods().find("web")->getNode(), "n1");
+
+    // Le doublon est refuse sans toucher au serveur
+    auto twin = make_unique<Pod>("web");
+    twin->addContainer(make_unique<Container>("c", 1.0, 1.0, "img"));
+    EXPECT_THROW({cluster.schedulePod(twin);}, DuplicatePodException);
+    EXPECT_NE(twin, nullptr);
+    EXPECT_DOUBLE_EQ(srv->getAvailableCpu(), 7.0);
+
+    vector<unique_ptr<Pod>> gang;
+    gang.push_back(make_unique<Pod>("new"));
+    gang.push_back(move(twin));
+    EXPECT_THROW({cluster.scheduleGang(gang);}, DuplicatePodException);
+    EXPECT_DOUBLE_EQ(srv->getAvailableCpu(), 7.0);
+    EXPECT_EQ(cluster.getPods().size(), 1u);
+}
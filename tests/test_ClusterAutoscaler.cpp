@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "ClusterAutoscaler.hpp"
+#include "TestHelpers.hpp"
+using namespace std;
+
+static AutoscalerConfig smallConfig() {
+    AutoscalerConfig config;
+    config.templates.push_back({"big", 8.0, 16.0, 2.0});
+    config.templates.push_back({"small", 2.0, 4.0, 0.5});
+    config.provisionDelay = 30.0;
+    config.scaleDownCooldown = 100.0;
+    return config;
+}
+
+TEST(ClusterAutoscalerTest, ScalesUpAfterProvisionDelay) {
+    KubernetesCluster cluster("c");
+    ClusterAutoscaler scaler(cluster, smallConfig());
+
+    vector<unique_ptr<Pod>> pending;
+    pending.push_back(makePod("a", 1.0, 1.0));
+    pending.push_back(makePod("b", 1.0, 1.0));
+    pending.push_back(makePod("c", 4.0, 4.0));
+
+    ScaleDecision d = scaler.tick(0.0, pending);
+    // c demande un "big", a et b tiennent dans le meme big
+    EXPECT_EQ(d.requested, 1u);
+    EXPECT_TRUE(cluster.getNodes().empty());
+
+    // Meme pods toujours pending : rien de plus n'est commande
+    d = scaler.tick(10.0, pending);
+    EXPECT_EQ(d.requested, 0u);
+
+    d = scaler.tick(30.0, pending);
+    EXPECT_EQ(d.added, 1u);
+    ASSERT_EQ(cluster.getNodes().size(), 1u);
+    EXPECT_EQ(cluster.getNodes()[0]->getId(), "big-1");
+    EXPECT_EQ(d.requested, 0u);
+}
+
+TEST(ClusterAutoscalerTest, PicksCheapestTemplateThatFits) {
+    KubernetesCluster cluster("c");
+    ClusterAutoscaler scaler(cluster, smallConfig());
+
+    vector<unique_ptr<Pod>> pending;
+    pending.push_back(makePod("a", 1.0, 1.0));
+    scaler.tick(0.0, pending);
+    scaler.tick(30.0, pending);
+    ASSERT_EQ(cluster.getNodes().size(), 1u);
+    EXPECT_EQ(cluster.getNodes()[0]->getId(), "small-1");
+}
+
+TEST(ClusterAutoscalerTest, RemovesIdleNodesAfterCooldown) {
+    KubernetesCluster cluster("c");
+    cluster.addServer(make_shared<Server>("n1", 4.0, 4.0));
+    cluster.addServer(make_shared<Server>("n2", 4.0, 4.0));
+    AutoscalerConfig config = smallConfig();
+    config.minNodes = 1;
+    ClusterAutoscaler scaler(cluster, config);
+
+    auto pod = makePod("p", 1.0, 1.0);
+    cluster.schedulePod(pod);   // -> n1, occupe
+
+    EXPECT_EQ(scaler.tick(50.0, {}).removed, 0u);
+    EXPECT_EQ(scaler.tick(100.0, {}).removed, 1u);
+    ASSERT_EQ(cluster.getNodes().size(), 1u);
+    EXPECT_EQ(cluster.getNodes()[0]->getId(), "n1");
+
+    // n1 devient vide, mais minNodes le garde
+    cluster.evictPod("p");
+    EXPECT_EQ(scaler.tick(500.0, {}).removed, 0u);
+    EXPECT_DOUBLE_EQ(scaler.getNodeSeconds(), 2 * 100.0 + 1 * 400.0);
+}
+
+TEST(ClusterAutoscalerTest, SimulatesTraceWithCostAndWait) {
+    KubernetesCluster cluster("sim");
+    AutoscalerConfig config = smallConfig();
+
+    // Un pic de 200 pods, puis plus rien
+    vector<TraceEntry> trace;
+    for (int i = 0; i < 200; ++i) {
+        trace.push_back({static_cast<double>(i), 600.0, makePod("p" + to_string(i), 1.0, 2.0)});
+    }
+
+    SimulationReport r = simulateAutoscaler(cluster, config, trace, 10.0);
+    EXPECT_EQ(r.podsScheduled, 200u);
+    EXPECT_EQ(r.podsUnscheduled, 0u);
+    EXPECT_GT(r.nodesAdded, 0u);
+    EXPECT_EQ(r.nodesRemoved, r.nodesAdded);   // tout redescend apres le pic
+    EXPECT_TRUE(cluster.getNodes().empty());
+    EXPECT_GT(r.cost, 0.0);
+    EXPECT_LE(r.maxWait, config.provisionDelay + 20.0);
+    EXPECT_GT(r.meanWait, 0.0);
+}
+
+TEST(ClusterAutoscalerTest, RejectsNonPositiveStep) {
+    KubernetesCluster cluster("sim");
+    vector<TraceEntry> trace;
+    trace.push_back({0.0, 10.0, makePod("p", 1.0, 1.0)});
+
+    EXPECT_THROW(simulateAutoscaler(cluster, smallConfig(), trace, 0.0), CloudException);
+    EXPECT_THROW(simulateAutoscaler(cluster, smallConfig(), trace, -5.0), CloudException);
+    EXPECT_NE(trace[0].pod, nullptr);
+}
+
+TEST(ClusterAutoscalerTest, DuplicateNameInTraceIsNoDemand) {
+    KubernetesCluster cluster("sim");
+    vector<TraceEntry> trace;
+    trace.push_back({0.0, 2000.0, makePod("p", 1.0, 1.0)});
+    trace.push_back({0.0, 10.0, makePod("p", 1.0, 1.0)});
+
+    SimulationReport r = simulateAutoscaler(cluster, smallConfig(), trace, 5.0);
+    EXPECT_EQ(r.podsScheduled, 1u);
+    EXPECT_EQ(r.podsUnscheduled, 1u);
+    EXPECT_EQ(r.nodesAdded, 1u);     // only the first "p" asked for a server
+    EXPECT_EQ(r.nodesRemoved, 1u);
+    EXPECT_EQ(r.peakNodes, 1u);
+    EXPECT_EQ(trace[0].pod, nullptr);
+    ASSERT_NE(trace[1].pod, nullptr);
+    EXPECT_DOUBLE_EQ(trace[1].pod->getCpuRequest(), 1.0);
+}
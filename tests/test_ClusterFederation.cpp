@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "ClusterFederation.hpp"
+#include "TestHelpers.hpp"
+using namespace std;
+
+TEST(ClusterFederationTest, RoutesByZoneLabel) {
+    ClusterFederation fed(ShardRouting::Zone);
+    size_t eu = fed.addShard("eu-west");
+    size_t us = fed.addShard("us-east");
+    fed.addServer(eu, make_shared<Server>("eu-1", 4.0, 4.0));
+    fed.addServer(us, make_shared<Server>("us-1", 4.0, 4.0));
+
+    auto pod = makePod("p", 1.0, 1.0);
+    pod->setLabel("zone", "us-east");
+    EXPECT_EQ(fed.route(*pod), us);
+
+    vector<unique_ptr<Pod>> pods;
+    pods.push_back(move(pod));
+    EXPECT_EQ(fed.deployPods(pods), 1u);
+    EXPECT_EQ(fed.getShard(us).getPods().size(), 1u);
+    EXPECT_EQ(fed.getShard(eu).getPods().size(), 0u);
+    EXPECT_DOUBLE_EQ(fed.getSummary(us).freeCpu, 3.0);
+    EXPECT_EQ(fed.getSummary(us).pods, 1u);
+}
+
+TEST(ClusterFederationTest, SpillsOverWhenFirstChoiceIsFull) {
+    ClusterFederation fed(ShardRouting::Zone);
+    size_t a = fed.addShard("a");
+    size_t b = fed.addShard("b");
+    size_t c = fed.addShard("c");
+    fed.addServer(a, make_shared<Server>("a-1", 2.0, 2.0));
+    fed.addServer(b, make_shared<Server>("b-1", 1.0, 1.0));
+    fed.addServer(c, make_shared<Server>("c-1", 8.0, 8.0));
+
+    vector<unique_ptr<Pod>> pods;
+    for (int i = 0; i < 4; ++i) {
+        pods.push_back(makePod("p" + to_string(i), 2.0, 2.0));
+        pods.back()->setLabel("zone", "a");
+    }
+    pods.push_back(makePod("too-big", 16.0, 1.0));
+
+    EXPECT_EQ(fed.deployPods(pods), 4u);
+    EXPECT_EQ(fed.getShard(a).getPods().size(), 1u);
+    EXPECT_EQ(fed.getShard(b).getPods().size(), 0u);
+    EXPECT_EQ(fed.getShard(c).getPods().size(), 3u);
+    EXPECT_NE(pods[4], nullptr);   // ne tient nulle part, reste a l'appelant
+}
+
+TEST(ClusterFederationTest, HashRoutingSpreadsPodsOverShards) {
+    ClusterFederation fed(ShardRouting::Hash);
+    for (int s = 0; s < 4; ++s) {
+        size_t shard = fed.addShard("shard" + to_string(s));
+        for (int n = 0; n < 8; ++n) {
+            fed.addServer(shard, make_shared<Server>("s" + to_string(s) + "-n" + to_string(n), 8.0, 16.0));
+        }
+    }
+
+    vector<unique_ptr<Pod>> pods;
+    for (int i = 0; i < 400; ++i) {
+        pods.push_back(makePod("pod-" + to_string(i), 0.5, 1.0));
+    }
+    EXPECT_EQ(fed.deployPods(pods), 400u);
+
+    size_t total = 0;
+    for (size_t s = 0; s < fed.size(); ++s) {
+        EXPECT_GT(fed.getShard(s).getPods().size(), 0u);
+        total += fed.getSummary(s).pods;
+    }
+    EXPECT_EQ(total, 400u);
+}
+
+TEST(ClusterFederationTest, ShardErrorIsRethrownAfterJoin) {
+    struct FailingListener : ClusterListener {
+        void onPodScheduled(const Pod&, const Server&) override {
+            throw runtime_error("listener en panne");
+        }
+    } failing;
+
+    ClusterFederation fed(ShardRouting::Hash);
+    for (int s = 0; s < 2; ++s) {
+        size_t shard = fed.addShard("shard" + to_string(s));
+        fed.addServer(shard, make_shared<Server>("s" + to_string(s), 8.0, 8.0));
+    }
+    fed.getShard(0).addListener(&failing);
+
+    vector<unique_ptr<Pod>> pods;
+    for (int i = 0; i < 20; ++i) {
+        pods.push_back(makePod("pod-" + to_string(i), 0.1, 0.1));
+    }
+    // Without the capture the worker thread would call std::terminate
+    EXPECT_THROW(fed.deployPods(pods), runtime_error);
+    fed.getShard(0).removeListener(&failing);
+}
+
+TEST(ClusterFederationTest, DuplicateNamesNeverReachAShard) {
+    ClusterFederation fed(ShardRouting::Zone);
+    size_t a = fed.addShard("a");
+    size_t b = fed.addShard("b");
+    fed.addServer(a, make_shared<Server>("a-1", 8.0, 8.0));
+    fed.addServer(b, make_shared<Server>("b-1", 8.0, 8.0));
+
+    // Les deux "same" iraient sur deux shards differents, donc deux threads
+    vector<unique_ptr<Pod>> pods;
+    pods.push_back(makePod("same", 1.0, 1.0));
+    pods.back()->setLabel("zone", "a");
+    pods.push_back(makePod("same", 1.0, 1.0));
+    pods.back()->setLabel("zone", "b");
+    pods.push_back(makePod("other", 1.0, 1.0));
+    pods.back()->setLabel("zone", "b");
+
+    EXPECT_EQ(fed.deployPods(pods), 2u);
+    EXPECT_EQ(pods[0], nullptr);
+    ASSERT_NE(pods[1], nullptr);   // le doublon reste a l'appelant
+    EXPECT_EQ(fed.getShard(a).getPods().size(), 1u);
+    EXPECT_EQ(fed.getShard(b).getPods().size(), 1u);
+    EXPECT_TRUE(fed.contains("same"));
+
+    // Un nom deja place dans un shard est refuse aussi, meme route vers un autre
+    vector<unique_ptr<Pod>> again;
+    again.push_back(move(pods[1]));
+    EXPECT_EQ(fed.deployPods(again), 0u);
+    EXPECT_NE(again[0], nullptr);
+    EXPECT_EQ(fed.getShard(b).getPods().size(), 1u);
+    EXPECT_DOUBLE_EQ(fed.getSummary(b).freeCpu, 7.0);
+}
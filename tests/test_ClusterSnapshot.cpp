@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "ClusterSnapshot.hpp"
+#include "TestHelpers.hpp"
+using namespace std;
+
+TEST(ClusterSnapshotTest, FromClusterCopiesCapacityAndPods) {
+    KubernetesCluster cluster("c");
+    cluster.addServer(make_shared<Server>("n1", 4.0, 8.0));
+    cluster.addServer(make_shared<Server>("n2", 2.0, 4.0));
+    auto pod = makePod("p1", 1.0, 2.0);
+    cluster.schedulePod(pod);
+
+    ClusterSnapshot snap = ClusterSnapshot::fromCluster(cluster);
+    ASSERT_EQ(snap.size(), 2u);
+    EXPECT_DOUBLE_EQ(snap.getNode("n1").available_cpu, 3.0);
+    EXPECT_EQ(snap.getNode("n1").pods.size(), 1u);
+
+    SnapshotSummary s = snap.summary();
+    EXPECT_DOUBLE_EQ(s.capacityCpu, 6.0);
+    EXPECT_DOUBLE_EQ(s.allocatedCpu, 1.0);
+    EXPECT_EQ(s.placedPods, 1u);
+}
+
+TEST(ClusterSnapshotTest, ForkDoesNotTouchBaseline) {
+    KubernetesCluster cluster("c");
+    cluster.addServer(make_shared<Server>("n1", 4.0, 8.0));
+    ClusterSnapshot base = ClusterSnapshot::fromCluster(cluster);
+
+    ClusterSnapshot what_if = base.fork();
+    auto pod = makePod("p", 3.0, 3.0);
+    what_if.schedulePod(*pod);
+    what_if.addNode("extra", 8.0, 8.0);
+
+    EXPECT_DOUBLE_EQ(what_if.getNode("n1").available_cpu, 1.0);
+    EXPECT_EQ(what_if.size(), 2u);
+
+    EXPECT_DOUBLE_EQ(base.getNode("n1").available_cpu, 4.0);
+    EXPECT_EQ(base.size(), 1u);
+    EXPECT_THROW({base.getNode("extra");}, CloudException);
+
+    // Le cluster reel n'est pas modifie non plus
+    EXPECT_DOUBLE_EQ(cluster.getNodes()[0]->getAvailableCpu(), 4.0);
+}
+
+TEST(ClusterSnapshotTest, ForkWriteClonesOnlyTheTouchedChunk) {
+    ClusterSnapshot base;
+    for (int i = 0; i < 100; ++i) {
+        base.addNode("n" + to_string(i), 4.0, 8.0);
+    }
+
+    // Meme adresse = meme chunk partage avec la baseline
+    ClusterSnapshot what_if = base.fork();
+    for (size_t i = 0; i < base.size(); ++i) {
+        EXPECT_EQ(&what_if.getNode(i), &base.getNode(i));
+    }
+
+    auto pod = makePod("p", 1.0, 1.0);
+    what_if.schedulePod(*pod);   // -> n0, premier chunk (0..31)
+    for (size_t i = 0; i < 32; ++i) {
+        EXPECT_NE(&what_if.getNode(i), &base.getNode(i));
+    }
+    for (size_t i = 32; i < base.size(); ++i) {
+        EXPECT_EQ(&what_if.getNode(i), &base.getNode(i));
+    }
+
+    // addNode only clones the last chunk (96..) and the index path
+    what_if.addNode("extra", 8.0, 8.0);
+    for (size_t i = 32; i < 96; ++i) {
+        EXPECT_EQ(&what_if.getNode(i), &base.getNode(i));
+    }
+    EXPECT_EQ(what_if.getNode("extra").initial_cpu, 8.0);
+    EXPECT_EQ(&what_if.getNode("n50"), &base.getNode("n50"));
+    EXPECT_THROW({base.getNode("extra");}, CloudException);
+    EXPECT_DOUBLE_EQ(base.getNode("n0").available_cpu, 4.0);
+}
+
+TEST(ClusterSnapshotTest, LargeSnapshotFindsEveryNode) {
+    ClusterSnapshot snap;
+    for (int i = 0; i < 5000; ++i) {
+        snap.addNode("n" + to_string(i), 1.0 + i, 1.0);
+    }
+    ClusterSnapshot fork = snap.fork();
+    fork.addNode("late", 1.0, 1.0);
+
+    ASSERT_EQ(snap.size(), 5000u);
+    for (int i = 0; i < 5000; ++i) {
+        EXPECT_DOUBLE_EQ(snap.getNode("n" + to_string(i)).initial_cpu, 1.0 + i);
+        EXPECT_EQ(fork.getNode(i).id, "n" + to_string(i));
+    }
+    EXPECT_THROW({snap.addNode("n42", 1.0, 1.0);}, CloudException);
+    EXPECT_EQ(fork.getNode("late").id, "late");
+}
+
+TEST(ClusterSnapshotTest, DrainMovesPodsToOtherNodes) {
+    ClusterSnapshot snap;
+    snap.addNode("n1", 4.0, 4.0);
+    snap.addNode("n2", 4.0, 4.0);
+
+    auto a = makePod("a", 2.0, 2.0);
+    auto b = makePod("b", 3.0, 1.0);
+    snap.schedulePod(*a);   // -> n1
+    snap.schedulePod(*b);   // -> n2
+
+    snap.drainNode("n1");
+    EXPECT_TRUE(snap.getNode("n1").drained);
+    EXPECT_DOUBLE_EQ(snap.getNode("n2").available_cpu, 4.0 - 3.0);
+
+    // a (2 cpu) ne tient plus sur n2
+    SnapshotSummary s = snap.summary();
+    EXPECT_EQ(s.activeNodes, 1u);
+    EXPECT_EQ(s.placedPods, 1u);
+    EXPECT_EQ(s.unplacedPods, 1u);
+    EXPECT_DOUBLE_EQ(s.allocatedCpu, 3.0);
+}
+
+TEST(ClusterSnapshotTest, ParallelScenariosFromOneBaseline) {
+    ClusterSnapshot base;
+    for (int i = 0; i < 100; ++i) {
+        base.addNode("n" + to_string(i), 4.0, 8.0);
+    }
+
+    vector<unique_ptr<Pod>> burst;
+    for (int i = 0; i < 150; ++i) {
+        burst.push_back(makePod("p" + to_string(i), 2.0, 2.0));
+    }
+
+    vector<function<void(ClusterSnapshot&)>> scenarios;
+    scenarios.push_back([&](ClusterSnapshot& s) { s.schedulePods(burst); });
+    scenarios.push_back([&](ClusterSnapshot& s) {
+        for (int i = 0; i < 50; ++i) {
+            s.drainNode("n" + to_string(i));
+        }
+        s.schedulePods(burst);
+    });
+    scenarios.push_back([&](ClusterSnapshot& s) {
+        for (int i = 0; i < 10; ++i) {
+            s.addNode("new" + to_string(i), 4.0, 8.0);
+        }
+        s.schedulePods(burst);
+    });
+
+    vector<SnapshotSummary> results = runWhatIf(base, scenarios);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].placedPods, 150u);
+    EXPECT_EQ(results[1].placedPods, 100u);
+    EXPECT_EQ(results[1].unplacedPods, 50u);
+    EXPECT_EQ(results[2].placedPods, 150u);
+    EXPECT_GT(results[0].cpuUtilization(), results[2].cpuUtilization());
+
+    EXPECT_EQ(base.summary().placedPods, 0u);
+    EXPECT_DOUBLE_EQ(base.summary().allocatedCpu, 0.0);
+}
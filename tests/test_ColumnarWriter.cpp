@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include "ClusterExport.hpp"
+#include "ClusterAutoscaler.hpp"
+#include "Exceptions.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+using namespace std;
+
+// Lecteur minimal du format, comme notebooks/cloudsim_columns.py
+struct Table {
+    vector<string> names;
+    vector<uint8_t> types;
+    vector<vector<double>> floats;
+    vector<vector<int64_t>> ints;
+    vector<vector<string>> strings;   // valeurs decodees
+    size_t batches = 0;
+    uint64_t footerRows = 0;
+};
+
+static Table readTable(const string& filename) {
+    ifstream in(filename, ios::binary);
+    const string buf((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    size_t pos = 0;
+    auto take = [&](void* out, size_t n) {
+        if (pos + n > buf.size()) {
+            throw runtime_error("truncated");
+        }
+        memcpy(out, buf.data() + pos, n);
+        pos += n;
+    };
+    auto align = [&]() { pos = (pos + 7) / 8 * 8; };
+
+    Table t;
+    char magic[8];
+    uint32_t version, count;
+    take(magic, 8);
+    EXPECT_EQ(string(magic, 8), "CSIMCOL1");
+    take(&version, 4);
+    take(&count, 4);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t type[2];
+        uint16_t length;
+        take(type, 2);
+        take(&length, 2);
+        t.names.push_back(buf.substr(pos, length));
+        pos += length;
+        t.types.push_back(type[0]);
+    }
+    align();
+    t.floats.resize(count);
+    t.ints.resize(count);
+    t.strings.resize(count);
+    vector<vector<string>> dictionaries(count);
+
+    while (true) {
+        uint64_t rows;
+        take(&rows, 8);
+        if (rows == 0) {
+            take(&t.footerRows, 8);
+            break;
+        }
+        ++t.batches;
+        for (uint32_t c = 0; c < count; ++c) {
+            if (t.types[c] != 2) {
+                continue;
+            }
+            uint32_t fresh;
+            take(&fresh, 4);
+            for (uint32_t e = 0; e < fresh; ++e) {
+                uint32_t length;
+                take(&length, 4);
+                dictionaries[c].push_back(buf.substr(pos, length));
+                pos += length;
+            }
+        }
+        align();
+        for (uint32_t c = 0; c < count; ++c) {
+            EXPECT_EQ(pos % 8, 0u);
+            for (uint64_t r = 0; r < rows; ++r) {
+                if (t.types[c] == 0) {
+                    double v;
+                    take(&v, 8);
+                    t.floats[c].push_back(v);
+                } else if (t.types[c] == 1) {
+                    int64_t v;
+                    take(&v, 8);
+                    t.ints[c].push_back(v);
+                } else {
+                    int32_t code;
+                    take(&code, 4);
+                    t.strings[c].push_back(dictionaries[c].at(static_cast<size_t>(code)));
+                }
+            }
+            align();
+        }
+    }
+    EXPECT_EQ(pos, buf.size());
+    return t;
+}
+
+TEST(ColumnarWriterTest, StreamsBatchesWithDeltaDictionaries) {
+    const string file = "test_columnar_batches.col";
+    {
+        ColumnarWriter writer(file, {
+            {"x", ColumnType::Float64},
+            {"n", ColumnType::Int64},
+            {"tag", ColumnType::String},
+        }, 4);
+        for (int i = 0; i < 10; ++i) {
+            writer.addFloat(i * 0.5).addInt(-i).addString(i % 3 == 0 ? "a" : "b" + to_string(i / 4)).endRow();
+        }
+        writer.close();
+        EXPECT_EQ(writer.getRows(), 10u);
+        EXPECT_EQ(writer.getBatches(), 3u);   // 4 + 4 + 2
+    }
+
+    Table t = readTable(file);
+    EXPECT_EQ(t.names, (vector<string>{"x", "n", "tag"}));
+    EXPECT_EQ(t.batches, 3u);
+    EXPECT_EQ(t.footerRows, 10u);
+    ASSERT_EQ(t.floats[0].size(), 10u);
+    EXPECT_DOUBLE_EQ(t.floats[0][7], 3.5);
+    EXPECT_EQ(t.ints[1][9], -9);
+    EXPECT_EQ(t.strings[2][0], "a");
+    EXPECT_EQ(t.strings[2][5], "b1");
+    EXPECT_EQ(t.strings[2][9], "a");
+    remove(file.c_str());
+}
+
+TEST(ColumnarWriterTest, RejectsMalformedRows) {
+    const string file = "test_columnar_errors.col";
+    ColumnarWriter writer(file, {{"x", ColumnType::Float64}, {"tag", ColumnType::String}});
+    EXPECT_THROW(writer.addInt(1), CloudException);          // mauvais type
+    writer.addFloat(1.0);
+    EXPECT_THROW(writer.endRow(), CloudException);           // ligne incomplete
+    writer.addString("ok").endRow();
+    EXPECT_THROW(writer.addFloat(2.0).addString("x").addFloat(3.0), CloudException);
+    remove(file.c_str());
+
+    EXPECT_THROW(ColumnarWriter("/nonexistent/dir/t.col", {{"x", ColumnType::Float64}}), FileException);
+}
+
+TEST(ColumnarWriterTest, ExportsClusterTables) {
+    KubernetesCluster cluster("c");
+    cluster.addServer(make_shared<Server>("n1", 4.0, 8.0));
+    cluster.addServer(make_shared<Server>("n2", 2.0, 2.0));
+    auto web = make_unique<Pod>("web");
+    web->addContainer(make_unique<Container>("app", 1.0, 2.0, "nginx"));
+    web->addContainer(make_unique<Container>("log", 0.5, 0.5, "fluentd"));
+    cluster.schedulePod(web);
+
+    const uint64_t bytes = exportCluster(cluster, "test_export_");
+    EXPECT_GT(bytes, 0u);
+
+    Table servers = readTable("test_export_servers.col");
+    EXPECT_EQ(servers.strings[0], (vector<string>{"n1", "n2"}));
+    EXPECT_DOUBLE_EQ(servers.floats[3][0], 2.5);
+    EXPECT_EQ(servers.ints[5], (vector<int64_t>{1, 0}));
+
+    Table pods = readTable("test_export_pods.col");
+    EXPECT_EQ(pods.strings[1], (vector<string>{"n1"}));
+    EXPECT_EQ(pods.ints[2][0], 2);
+    EXPECT_DOUBLE_EQ(pods.floats[3][0], 1.5);
+
+    Table containers = readTable("test_export_containers.col");
+    EXPECT_EQ(containers.strings[0], (vector<string>{"web", "web"}));
+    EXPECT_EQ(containers.strings[2], (vector<string>{"nginx", "fluentd"}));
+
+    for (const char* f: {"test_export_servers.col", "test_export_pods.col", "test_export_containers.col"}) {
+        remove(f);
+    }
+}
+
+TEST(ColumnarWriterTest, RecordsSimulationUtilization) {
+    KubernetesCluster cluster("c");
+    AutoscalerConfig config;
+    config.templates = {{"node", 4.0, 8.0, 1.0}};
+    config.provisionDelay = 10.0;
+    config.scaleDownCooldown = 20.0;
+
+    vector<TraceEntry> trace;
+    auto pod = make_unique<Pod>("job");
+    pod->addContainer(make_unique<Container>("c", 2.0, 2.0, "img"));
+    trace.push_back({0.0, 30.0, move(pod)});
+
+    const string file = "test_utilization.col";
+    UtilizationRecorder recorder(file);
+    simulateAutoscaler(cluster, config, trace, 5.0, &recorder);
+    recorder.close();
+    EXPECT_GT(recorder.getRows(), 0u);
+
+    Table t = readTable(file);
+    EXPECT_EQ(t.footerRows, recorder.getRows());
+    double peak = 0.0;
+    for (double u: t.floats[4]) {
+        peak = max(peak, u);
+    }
+    EXPECT_DOUBLE_EQ(peak, 0.5);   // 2 cpu sur 4
+    remove(file.c_str());
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "Instrumentation.hpp"
+#include "KubernetesCluster.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+TEST(InstrumentationTest, HistogramBucketsAreMonotonicAndTight) {
+    size_t previous = 0;
+    for (uint64_t v = 0; v < 100000; v += 7) {
+        size_t b = LatencyHistogram::bucketOf(v);
+        EXPECT_GE(b, previous);
+        EXPECT_LT(b, LatencyHistogram::BUCKETS);
+        EXPECT_GE(LatencyHistogram::upperEdge(b), v);
+        // Precision : l'erreur relative reste sous ~6%
+        EXPECT_LE(static_cast<double>(LatencyHistogram::upperEdge(b) - v), 0.0625 * static_cast<double>(v) + 1.0);
+        previous = b;
+    }
+    EXPECT_LT(LatencyHistogram::bucketOf(UINT64_MAX), LatencyHistogram::BUCKETS);
+}
+
+TEST(InstrumentationTest, HistogramPercentiles) {
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        h.record(v * 1000);
+    }
+    EXPECT_EQ(h.count(), 1000u);
+    EXPECT_EQ(h.max(), 1000000u);
+    EXPECT_NEAR(h.mean(), 500500.0, 1.0);
+    EXPECT_NEAR(static_cast<double>(h.percentile(50)), 500000.0, 500000.0 * 0.07);
+    EXPECT_NEAR(static_cast<double>(h.percentile(99)), 990000.0, 990000.0 * 0.07);
+    EXPECT_EQ(h.percentile(100), 1000000u);
+
+    LatencyHistogram copy = h;
+    copy.merge(h);
+    EXPECT_EQ(copy.count(), 2000u);
+}
+
+TEST(InstrumentationTest, SchedulerFeedsCountersAndTrace) {
+    if (!Instrumentation::compiledIn()) {
+        GTEST_SKIP() << "built without CLOUDSIM_INSTRUMENTATION";
+    }
+    Instrumentation::reset();
+    Instrumentation::enableTrace(true);
+
+    KubernetesCluster cluster("c");
+    cluster.addServer(make_shared<Server>("n1", 1.0, 1.0));
+    cluster.addServer(make_shared<Server>("n2", 4.0, 4.0));
+
+    auto p1 = make_unique<Pod>("p1");
+    p1->addContainer(make_unique<Container>("c1", 2.0, 2.0, "img"));
+    cluster.schedulePod(p1);   // n1 trop petit -> 2 noeuds regardes
+
+    auto p2 = make_unique<Pod>("p2");
+    p2->addContainer(make_unique<Container>("c2", 8.0, 8.0, "img"));
+    EXPECT_THROW({cluster.schedulePod(p2);}, AllocationException);
+
+    vector<unique_ptr<Pod>> gang;
+    gang.push_back(move(p2));
+    EXPECT_THROW({cluster.scheduleGang(gang);}, AllocationException);   // 2 noeuds regardes
+
+    // p1 est deja place : rollback avant tout scan
+    gang.clear();
+    gang.push_back(make_unique<Pod>("p1"));
+    EXPECT_THROW({cluster.scheduleGang(gang);}, DuplicatePodException);
+
+    Instrumentation::enableTrace(false);
+    InstrumentationReport r = Instrumentation::collect();
+    EXPECT_EQ(r.get(Counter::ScheduleAttempts), 4u);
+    EXPECT_EQ(r.get(Counter::NodesScanned), 6u);
+    EXPECT_EQ(r.get(Counter::ScheduleFailures), 1u);
+    EXPECT_EQ(r.get(Counter::GangRollbacks), 2u);
+    EXPECT_EQ(r.get(Timer::Schedule).count(), 2u);
+    EXPECT_NE(r.toString().find("schedule_attempts = 4"), string::npos);
+
+    ASSERT_EQ(Instrumentation::traceSize(), 2u);
+    const string path = "test_instrumentation_trace.json";
+    Instrumentation::dumpTrace(path);
+    ifstream in(path);
+    stringstream content;
+    content << in.rdbuf();
+    EXPECT_NE(content.str().find("\"traceEvents\""), string::npos);
+    EXPECT_NE(content.str().find("p1 -> n2"), string::npos);
+    EXPECT_NE(content.str().find("p2 -> unschedulable"), string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(InstrumentationTest, TraceStartsAtTheEarliestEvent) {
+    Instrumentation::reset();
+    Instrumentation::enableTrace(true);
+    // An inner scope ends first : it is pushed before the outer one that started earlier
+    Instrumentation::traceEvent(Timer::Schedule, 2000, 10, "inner");
+    Instrumentation::traceEvent(Timer::Schedule, 1000, 5000, "outer");
+    Instrumentation::enableTrace(false);
+
+    const string path = "test_instrumentation_origin.json";
+    Instrumentation::dumpTrace(path);
+    ifstream in(path);
+    stringstream content;
+    content << in.rdbuf();
+    EXPECT_NE(content.str().find("\"ts\":1.000,\"dur\":0.010"), string::npos);
+    EXPECT_NE(content.str().find("\"ts\":0.000,\"dur\":5.000"), string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(InstrumentationTest, CountersFromExitedThreadsAreKept) {
+    if (!Instrumentation::compiledIn()) {
+        GTEST_SKIP() << "built without CLOUDSIM_INSTRUMENTATION";
+    }
+    Instrumentation::reset();
+    vector<thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([]() {
+            CLOUDSIM_STATS();
+            for (int i = 0; i < 1000; ++i) {
+                CLOUDSIM_COUNT(ScheduleAttempts, 1);
+            }
+        });
+    }
+    for (auto& w: workers) {
+        w.join();
+    }
+    EXPECT_EQ(Instrumentation::collect().get(Counter::ScheduleAttempts), 4000u);
+}
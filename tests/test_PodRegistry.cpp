@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "PodRegistry.hpp"
+#include "Exceptions.hpp"
+#include <set>
+#include <type_traits>
+using namespace std;
+
+static PodHandle add(PodRegistry& registry, const string& name) {
+    auto pod = make_unique<Pod>(name);
+    return registry.insert(pod);
+}
+
+TEST(PodRegistryTest, FindsPodsByNameAndHandle) {
+    PodRegistry registry;
+    EXPECT_TRUE(registry.empty());
+    PodHandle a = add(registry, "a");
+    PodHandle b = add(registry, "b");
+
+    EXPECT_EQ(registry.size(), 2u);
+    EXPECT_EQ(registry.get(a)->getName(), "a");
+    EXPECT_EQ(registry.find("b"), registry.get(b));
+    EXPECT_EQ(registry.handleOf("b"), b);
+    EXPECT_EQ(registry.find("zzz"), nullptr);
+    EXPECT_FALSE(registry.handleOf("zzz").valid());
+}
+
+TEST(PodRegistryTest, DuplicateNameIsRejectedAndLeftToCaller) {
+    PodRegistry registry;
+    add(registry, "a");
+    auto again = make_unique<Pod>("a");
+    EXPECT_THROW(registry.insert(again), DuplicatePodException);
+    ASSERT_NE(again, nullptr);
+    EXPECT_EQ(registry.size(), 1u);
+}
+
+TEST(PodRegistryTest, RemoveSwapsLastPodIntoTheHole) {
+    PodRegistry registry;
+    PodHandle a = add(registry, "a");
+    PodHandle b = add(registry, "b");
+    PodHandle c = add(registry, "c");
+
+    unique_ptr<Pod> removed = registry.remove(a);
+    ASSERT_NE(removed, nullptr);
+    EXPECT_EQ(removed->getName(), "a");
+
+    // c a pris la place de a, les handles restants suivent
+    EXPECT_EQ(registry.size(), 2u);
+    EXPECT_EQ((*registry.begin())->getName(), "c");
+    EXPECT_EQ(registry.get(c)->getName(), "c");
+    EXPECT_EQ(registry.get(b)->getName(), "b");
+    EXPECT_EQ(registry.remove("a"), nullptr);
+}
+
+TEST(PodRegistryTest, HandlesGoStaleWhenSlotIsReused) {
+    PodRegistry registry;
+    PodHandle old = add(registry, "a");
+    registry.remove(old);
+    PodHandle fresh = add(registry, "b");
+
+    EXPECT_EQ(fresh.index, old.index);   // slot recycle
+    EXPECT_NE(fresh, old);
+    EXPECT_EQ(registry.get(old), nullptr);
+    EXPECT_EQ(registry.remove(old), nullptr);
+    EXPECT_EQ(registry.get(fresh)->getName(), "b");
+
+    registry.clear();
+    EXPECT_TRUE(registry.empty());
+    EXPECT_EQ(registry.get(fresh), nullptr);
+    EXPECT_FALSE(registry.contains("b"));
+}
+
+TEST(PodRegistryTest, IndexSurvivesChurnAndGrowth) {
+    PodRegistry registry;
+    set<string> expected;
+    // Insertions et retraits melanges : l'index grandit et se recompacte
+    for (int i = 0; i < 2000; ++i) {
+        add(registry, "pod-" + to_string(i));
+        expected.insert("pod-" + to_string(i));
+        if (i % 3 == 0) {
+            const string victim = "pod-" + to_string(i / 2);
+            EXPECT_EQ(registry.remove(victim) != nullptr, expected.erase(victim) == 1);
+        }
+    }
+
+    EXPECT_EQ(registry.size(), expected.size());
+    for (int i = 0; i < 2000; ++i) {
+        const string name = "pod-" + to_string(i);
+        const Pod* pod = registry.find(name);
+        ASSERT_EQ(pod != nullptr, expected.count(name) == 1) << name;
+        if (pod != nullptr) {
+            EXPECT_EQ(pod->getName(), name);
+        }
+    }
+}
+
+TEST(PodRegistryTest, DuplicateIsFoundPastRemovedNeighbours) {
+    PodRegistry registry;
+    for (int i = 0; i < 1000; ++i) {
+        add(registry, "pod-" + to_string(i));
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        registry.remove("pod-" + to_string(i));
+    }
+    // Les places liberees ne doivent ni cacher un pod, ni laisser passer un doublon
+    for (int i = 1; i < 1000; i += 2) {
+        auto again = make_unique<Pod>("pod-" + to_string(i));
+        EXPECT_THROW(registry.insert(again), DuplicatePodException);
+    }
+
+    // Beaucoup d'allers-retours a taille constante
+    for (int i = 0; i < 20000; ++i) {
+        const string name = "tmp-" + to_string(i);
+        add(registry, name);
+        ASSERT_NE(registry.remove(name), nullptr);
+    }
+    EXPECT_EQ(registry.size(), 500u);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(registry.contains("pod-" + to_string(i)), i % 2 == 1) << i;
+    }
+}
+
+TEST(PodRegistryTest, RegisteredPodsCannotBeRenamedOrTakenOut) {
+    PodRegistry registry;
+    add(registry, "a");
+    // L'iteration ne donne que des const unique_ptr<Pod>& : pas de move ni de reset
+    static_assert(is_same<decltype(*registry.begin()), const unique_ptr<Pod>&>::value,
+                  "registry iteration must not hand out the ownership");
+
+    Pod* pod = registry.find("a");
+    EXPECT_THROW(pod->setName("b"), CloudException);
+    EXPECT_TRUE(registry.contains("a"));
+    EXPECT_FALSE(registry.contains("b"));
+
+    // Une fois retire, le pod redevient renommable
+    unique_ptr<Pod> removed = registry.remove("a");
+    removed->setName("b");
+    EXPECT_EQ(removed->getName(), "b");
+    registry.insert(removed);
+    EXPECT_NE(registry.find("b"), nullptr);
+}
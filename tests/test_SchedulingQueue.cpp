@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "SchedulingQueue.hpp"
+#include "ClusterAutoscaler.hpp"
+#include "Exceptions.hpp"
+#include "TestHelpers.hpp"
+using namespace std;
+
+TEST(SchedulingQueueTest, ParksPodsGroupedByShape) {
+    KubernetesCluster cluster("c");
+    cluster.addServer(make_shared<Server>("n1", 2.0, 2.0));
+    double now = 0.0;
+    SchedulingQueue queue(cluster, [&]() { return now; });
+
+    auto ok = makePod("ok", 2.0, 2.0);
+    EXPECT_TRUE(queue.submit(ok));
+
+    for (int i = 0; i < 3; ++i) {
+        auto p = makePod("small" + to_string(i), 1.0, 1.0);
+        EXPECT_FALSE(queue.submit(p));
+        EXPECT_EQ(p, nullptr);   // le pod appartient maintenant a la queue
+    }
+    auto big = makePod("big", 4.0, 4.0);
+    EXPECT_FALSE(queue.submit(big));
+
+    EXPECT_EQ(queue.depth(), 4u);
+    EXPECT_EQ(queue.shapeCount(), 2u);
+
+    now = 5.0;
+    EXPECT_DOUBLE_EQ(queue.getStats().oldestWait, 5.0);
+}
+
+TEST(SchedulingQueueTest, EvictionRetriesOnlyShapesThatFit) {
+    KubernetesCluster cluster("c");
+    cluster.addServer(make_shared<Server>("n1", 2.0, 2.0));
+    double now = 0.0;
+    SchedulingQueue queue(cluster, [&]() { return now; });
+
+    auto running = makePod("running", 2.0, 2.0);
+    queue.submit(running);
+    auto a = makePod("a", 1.0, 1.0);
+    auto b = makePod("b", 1.0, 1.0);
+    auto c = makePod("c", 1.0, 1.0);
+    auto big = makePod("big", 3.0, 1.0);
+    queue.submit(a);
+    queue.submit(b);
+    queue.submit(c);
+    queue.submit(big);
+
+    now = 10.0;
+    cluster.evictPod("running");
+
+    // a et b prennent la place liberee, c attend, big n'est meme pas essaye
+    EXPECT_EQ(cluster.getPods().size(), 2u);
+    QueueStats s = queue.getStats();
+    EXPECT_EQ(s.depth, 2u);
+    EXPECT_EQ(s.scheduled, 2u);
+    EXPECT_EQ(s.retries, 2u);
+    EXPECT_EQ(s.wastedRetries, 0u);
+    EXPECT_DOUBLE_EQ(s.meanWait, 10.0);
+}
+
+TEST(SchedulingQueueTest, NewServerWakesParkedPods) {
+    KubernetesCluster cluster("c");
+    SchedulingQueue queue(cluster);
+
+    vector<unique_ptr<Pod>> pods;
+    for (int i = 0; i < 5; ++i) {
+        pods.push_back(makePod("p" + to_string(i), 1.0, 2.0));
+    }
+    for (auto& p: pods) {
+        queue.submit(p);
+    }
+    EXPECT_EQ(queue.depth(), 5u);
+
+    cluster.addServer(make_shared<Server>("n1", 3.0, 8.0));
+    EXPECT_EQ(queue.depth(), 2u);
+    cluster.addServer(make_shared<Server>("n2", 8.0, 8.0));
+    EXPECT_EQ(queue.depth(), 0u);
+    EXPECT_EQ(queue.shapeCount(), 0u);
+    EXPECT_EQ(cluster.getPods().size(), 5u);
+    EXPECT_EQ(queue.getStats().wastedRetries, 0u);
+}
+
+TEST(SchedulingQueueTest, NameAlreadyPlacedIsNotParked) {
+    KubernetesCluster cluster("c");
+    cluster.addServer(make_shared<Server>("n1", 2.0, 2.0));
+    SchedulingQueue queue(cluster);
+
+    auto first = makePod("a", 1.0, 1.0);
+    EXPECT_TRUE(queue.submit(first));
+    // Attendre ne servirait a rien : le doublon revient a l'appelant
+    auto twin = makePod("a", 1.0, 1.0);
+    EXPECT_THROW(queue.submit(twin), DuplicatePodException);
+    EXPECT_NE(twin, nullptr);
+    EXPECT_EQ(queue.depth(), 0u);
+    EXPECT_DOUBLE_EQ(cluster.getNodes()[0]->getAvailableCpu(), 1.0);
+}
+
+TEST(SchedulingQueueTest, RetryNeverThrowsOutOfTheListenerLoop) {
+    struct Counter : ClusterListener {
+        size_t added = 0;
+        void onServerAdded(const Server&) override { ++added; }
+    };
+
+    KubernetesCluster cluster("c");
+    cluster.addServer(make_shared<Server>("n1", 2.0, 2.0));
+    SchedulingQueue queue(cluster);
+    Counter after;   // registered after the queue
+    cluster.addListener(&after);
+
+    auto big = makePod("a", 4.0, 1.0);
+    EXPECT_FALSE(queue.submit(big));
+    auto other = makePod("a", 1.0, 1.0);
+    cluster.schedulePod(other);          // the name of the parked pod is now taken
+
+    // The parked "a" fails for another reason than capacity : set aside, no throw
+    EXPECT_NO_THROW(cluster.addServer(make_shared<Server>("n2", 8.0, 8.0)));
+    EXPECT_EQ(cluster.getNodes().size(), 2u);
+    EXPECT_EQ(after.added, 1u);      // the listener after the queue still hears about n2
+    EXPECT_EQ(queue.depth(), 0u);
+    EXPECT_EQ(queue.getStats().rejected, 1u);
+
+    vector<unique_ptr<Pod>> rejected = queue.takeRejected();
+    ASSERT_EQ(rejected.size(), 1u);
+    EXPECT_EQ(rejected[0]->getName(), "a");
+    EXPECT_DOUBLE_EQ(rejected[0]->getCpuRequest(), 4.0);
+    EXPECT_TRUE(queue.takeRejected().empty());
+    cluster.removeListener(&after);
+}
+
+TEST(SchedulingQueueTest, RetriesRunOnceEveryListenerHeardTheEvent) {
+    struct Recorder : ClusterListener {
+        vector<string> events;
+        void onServerAdded(const Server& s) override { events.push_back("added " + s.getId()); }
+        void onPodScheduled(const Pod& p, const Server&) override { events.push_back("scheduled " + p.getName()); }
+    };
+
+    KubernetesCluster cluster("c");
+    SchedulingQueue queue(cluster);
+    AutoscalerConfig config;
+    config.scaleDownCooldown = 100.0;
+    ClusterAutoscaler scaler(cluster, config);   // registered after the queue
+    Recorder after;
+    cluster.addListener(&after);
+
+    auto pod = makePod("p", 1.0, 1.0);
+    EXPECT_FALSE(queue.submit(pod));
+    cluster.addServer(make_shared<Server>("n1", 2.0, 2.0));
+    EXPECT_EQ(queue.depth(), 0u);
+    EXPECT_EQ(after.events, (vector<string>{"added n1", "scheduled p"}));
+
+    // The autoscaler saw the pod land on n1 : n1 is busy, not removed
+    EXPECT_EQ(scaler.getIdleNodes(), 0u);
+    EXPECT_NO_THROW(EXPECT_EQ(scaler.tick(100.0, {}).removed, 0u));
+    EXPECT_EQ(cluster.getNodes().size(), 1u);
+    cluster.removeListener(&after);
+}
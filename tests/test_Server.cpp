@@ -56,4 +56,19 @@ TEST(ServerTest, AllocateJustBelowLimits) {
     EXPECT_NO_THROW ({
         s.allocate(4.999999, 9.9999999);
     });
-}
\ No newline at end of file
+}
+
+TEST(ServerTest, ReleaseGivesBackCapacity) {
+    Server s("srv5", 4.0, 8.0);
+    s.allocate(3.0, 5.0);
+    EXPECT_FALSE(s.canAllocate(2.0, 1.0));
+    s.release(3.0, 5.0);
+    EXPECT_TRUE(s.canAllocate(4.0, 8.0));
+    EXPECT_DOUBLE_EQ(s.getAvailableCpu(), 4.0);
+    EXPECT_DOUBLE_EQ(s.getAvailableMem(), 8.0);
+
+    // Never above the initial capacity
+    s.release(1.0, 1.0);
+    EXPECT_DOUBLE_EQ(s.getAvailableCpu(), 4.0);
+    EXPECT_DOUBLE_EQ(s.getAvailableMem(), 8.0);
+}